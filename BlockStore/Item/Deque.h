@@ -6,10 +6,10 @@
 
 namespace BlockStore {
 
-constexpr size_t deque_block_size_limit = block_size_limit - 2 * sizeof(ref_t) - sizeof(size_t);
+constexpr size_t deque_block_size_limit = block_size_limit - flat_layout<std::pair<block_ref, block_ref>>::size - flat_layout<size_t>::size;
 
 template<class T>
-constexpr size_t deque_block_limit = deque_block_size_limit / layout_traits<T>::size();
+constexpr size_t deque_block_limit = deque_block_size_limit / flat_layout<T>::size;
 
 
 template<class T>
@@ -87,10 +87,11 @@ private:
 		SerializeContext context(get_manager());
 		SerializeChild(context, *item);
 		auto [data, ref_list] = context.Get();
-		if (data.size() > block_size_limit) {
+		if (data.size() > block_size_limit + 1) {
 			throw std::invalid_argument("block size exceeds limit");
 		}
 		write(data, ref_list);
+		SerializeContext::Recycle(std::move(data), std::move(ref_list));
 	}
 
 private:
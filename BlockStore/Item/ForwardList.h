@@ -12,7 +12,8 @@ struct ForwardListNode {
 	ForwardListNode() = default;
 	ForwardListNode(const block<ForwardListNode>& next, auto&&... args) : next(next), value(std::forward<decltype(args)>(args)...) {}
 
-	friend constexpr auto layout(layout_type<ForwardListNode>) { return declare(&ForwardListNode::next, &ForwardListNode::value); }
+	using layout_members = member_layout<&ForwardListNode::next, &ForwardListNode::value>;
+	friend constexpr auto layout(layout_type<ForwardListNode>) { return layout_members::declare(); }
 };
 
 
@@ -29,7 +30,8 @@ private:
 		Sentinel(const block_ref& root) : next(root) {}
 		Sentinel(const block<Node>& next) : next(next) {}
 
-		friend constexpr auto layout(layout_type<Sentinel>) { return declare(&Sentinel::next); }
+		using layout_members = member_layout<&Sentinel::next>;
+		friend constexpr auto layout(layout_type<Sentinel>) { return layout_members::declare(); }
 	};
 
 public:
@@ -65,10 +67,27 @@ public:
 
 	private:
 		const block_view_local<Sentinel>* root;
+		CacheType* cache;
 		block_view_lazy<Node, CacheType> curr;
+		block_read_ahead<Node, CacheType> ahead;
 
 	private:
-		iterator(const block_view_local<Sentinel>& root, block_view_lazy<Node, CacheType> curr) : root(&root), curr(std::move(curr)) {}
+		iterator(const block_view_local<Sentinel>& root, CacheType& cache, block_view_lazy<Node, CacheType> curr) : root(&root), cache(&cache), curr(std::move(curr)) {}
+
+	private:
+		// the next node is read while the caller works on the current one
+		void read_ahead(const Node& node) {
+			if (node.next != *root) {
+				ahead.start(*cache, node.next);
+			}
+		}
+		void advance(block<Node> next) {
+			if (auto node = ahead.take(next)) {
+				curr = std::move(*node);
+			} else {
+				curr = std::move(next);
+			}
+		}
 
 	public:
 		bool operator==(const iterator& other) const { return curr == other.curr; }
@@ -77,18 +96,22 @@ public:
 			if (curr == *root) {
 				throw std::invalid_argument("cannot dereference end forward_list iterator");
 			}
-			return block_view<Node, CacheType>(curr);
+			block_view<Node, CacheType> node(curr);
+			read_ahead(node.get());
+			return node;
 		}
 
 		const T* operator->() {
 			if (curr == *root) {
 				throw std::invalid_argument("cannot dereference end forward_list iterator");
 			}
-			return &curr.get().value;
+			const Node& node = curr.get();
+			read_ahead(node);
+			return &node.value;
 		}
 
 		iterator& operator++() {
-			curr = curr == *root ? root->get().next : curr.get().next;
+			advance(curr == *root ? root->get().next : curr.template get_field<&Node::next>());
 			return *this;
 		}
 	};
@@ -105,8 +128,8 @@ private:
 public:
 	bool empty() const { return root.get().next == root; }
 
-	iterator before_begin() const { return iterator(root, cache.read_lazy(root)); }
-	iterator begin() const { return iterator(root, cache.read_lazy(root.get().next)); }
+	iterator before_begin() const { return iterator(root, cache, cache.read_lazy(root)); }
+	iterator begin() const { return iterator(root, cache, cache.read_lazy(root.get().next)); }
 	iterator end() const { return before_begin(); }
 
 	value_wrapper front() const {
@@ -127,8 +150,8 @@ public:
 	iterator emplace_front(auto&&... args) {
 		return cache.transaction([&] {
 			block_view<Node, CacheType> new_node = cache.create(root.get().next, std::forward<decltype(args)>(args)...);
-			root.update([&](Sentinel& r) { r.next = new_node; });
-			return iterator(root, std::move(new_node));
+			root.template set_field<&Sentinel::next>(new_node);
+			return iterator(root, cache, std::move(new_node));
 		});
 	}
 
@@ -137,9 +160,9 @@ public:
 			return emplace_front(std::forward<decltype(args)>(args)...);
 		}
 		return cache.transaction([&] {
-			block_view<Node, CacheType> new_node = cache.create(pos.curr.get().next, std::forward<decltype(args)>(args)...);
-			pos.curr.update([&](Node& n) { n.next = new_node; });
-			return iterator(root, std::move(new_node));
+			block_view<Node, CacheType> new_node = cache.create(pos.curr.template get_field<&Node::next>(), std::forward<decltype(args)>(args)...);
+			pos.curr.template set_field<&Node::next>(new_node);
+			return iterator(root, cache, std::move(new_node));
 		});
 	}
 
@@ -148,9 +171,9 @@ public:
 			throw std::invalid_argument("forward_list is empty");
 		}
 		return cache.transaction([&] {
-			block_view<Node, CacheType> next = cache.read(root.get().next);
-			root.update([&](Sentinel& r) { r.next = next.get().next; });
-			return iterator(root, cache.read_lazy(next.get().next));
+			block<Node> next = cache.read_lazy(root.get().next).template get_field<&Node::next>();
+			root.template set_field<&Sentinel::next>(next);
+			return iterator(root, cache, cache.read_lazy(std::move(next)));
 		});
 	}
 
@@ -158,13 +181,13 @@ public:
 		if (pos == before_begin()) {
 			return pop_front();
 		}
-		if (pos.curr.get().next == root) {
+		if (pos.curr.template get_field<&Node::next>() == root) {
 			throw std::invalid_argument("forward_list erase iterator outside range");
 		}
 		return cache.transaction([&] {
-			block_view<Node, CacheType> next = cache.read(pos.curr.get().next);
-			pos.curr.update([&](Node& n) { n.next = next.get().next; });
-			return iterator(root, cache.read_lazy(next.get().next));
+			block<Node> next = cache.read_lazy(pos.curr.template get_field<&Node::next>()).template get_field<&Node::next>();
+			pos.curr.template set_field<&Node::next>(next);
+			return iterator(root, cache, cache.read_lazy(std::move(next)));
 		});
 	}
 };
@@ -13,7 +13,8 @@ struct ListNode {
 	ListNode() = default;
 	ListNode(const block<ListNode>& next, const block<ListNode>& prev, auto&&... args) : next(next), prev(prev), value(std::forward<decltype(args)>(args)...) {}
 
-	friend constexpr auto layout(layout_type<ListNode>) { return declare(&ListNode::next, &ListNode::prev, &ListNode::value); }
+	using layout_members = member_layout<&ListNode::next, &ListNode::prev, &ListNode::value>;
+	friend constexpr auto layout(layout_type<ListNode>) { return layout_members::declare(); }
 };
 
 
@@ -31,7 +32,8 @@ private:
 		Sentinel(const block_ref& root) : next(root), prev(root) {}
 		Sentinel(const block<Node>& next, const block<Node>& prev) : next(next), prev(prev) {}
 
-		friend constexpr auto layout(layout_type<Sentinel>) { return declare(&Sentinel::next, &Sentinel::prev); }
+		using layout_members = member_layout<&Sentinel::next, &Sentinel::prev>;
+		friend constexpr auto layout(layout_type<Sentinel>) { return layout_members::declare(); }
 	};
 
 public:
@@ -64,10 +66,27 @@ public:
 
 	private:
 		const block_view_local<Sentinel>* root;
+		CacheType* cache;
 		block_view_lazy<Node, CacheType> curr;
+		block_read_ahead<Node, CacheType> ahead;
 
 	private:
-		iterator(const block_view_local<Sentinel>& root, block_view_lazy<Node, CacheType> curr) : root(&root), curr(std::move(curr)) {}
+		iterator(const block_view_local<Sentinel>& root, CacheType& cache, block_view_lazy<Node, CacheType> curr) : root(&root), cache(&cache), curr(std::move(curr)) {}
+
+	private:
+		// the next node is read while the caller works on the current one
+		void read_ahead(const Node& node) {
+			if (node.next != *root) {
+				ahead.start(*cache, node.next);
+			}
+		}
+		void advance(block<Node> next) {
+			if (auto node = ahead.take(next)) {
+				curr = std::move(*node);
+			} else {
+				curr = std::move(next);
+			}
+		}
 
 	public:
 		bool operator==(const iterator& other) const { return curr == other.curr; }
@@ -76,21 +95,25 @@ public:
 			if (curr == *root) {
 				throw std::invalid_argument("cannot dereference end list iterator");
 			}
-			return block_view<Node, CacheType>(curr);
+			block_view<Node, CacheType> node(curr);
+			read_ahead(node.get());
+			return node;
 		}
 
 		const T* operator->() {
 			if (curr == *root) {
 				throw std::invalid_argument("cannot dereference end list iterator");
 			}
-			return &curr.get().value;
+			const Node& node = curr.get();
+			read_ahead(node);
+			return &node.value;
 		}
 
 		iterator& operator++() {
 			if (curr == *root) {
 				throw std::invalid_argument("cannot increment end list iterator");
 			}
-			curr = curr.get().next;
+			advance(curr.template get_field<&Node::next>());
 			return *this;
 		}
 
@@ -100,10 +123,11 @@ public:
 		}
 
 		iterator& operator--() {
-			block<Node> prev = curr == *root ? root->get().prev : curr.get().prev;
+			block<Node> prev = curr == *root ? root->get().prev : curr.template get_field<&Node::prev>();
 			if (prev == *root) {
 				throw std::invalid_argument("cannot decrement begin list iterator");
 			}
+			ahead.reset();
 			curr = prev;
 			return *this;
 		}
@@ -126,8 +150,8 @@ private:
 public:
 	bool empty() const { return root.get().next == root; }
 
-	iterator begin() const { return iterator(root, cache.read_lazy(root.get().next)); }
-	iterator end() const { return iterator(root, cache.read_lazy(root)); }
+	iterator begin() const { return iterator(root, cache, cache.read_lazy(root.get().next)); }
+	iterator end() const { return iterator(root, cache, cache.read_lazy(root)); }
 
 	std::reverse_iterator<iterator> rbegin() const { return std::reverse_iterator<iterator>(end()); }
 	std::reverse_iterator<iterator> rend() const { return std::reverse_iterator<iterator>(begin()); }
@@ -160,11 +184,10 @@ public:
 			if (empty()) {
 				root.update([&](Sentinel& r) { r.next = r.prev = new_node; });
 			} else {
-				block_view<Node, CacheType> back = cache.read(root.get().prev);
-				back.update([&](Node& n) { n.next = new_node; });
-				root.update([&](Sentinel& r) { r.prev = new_node; });
+				cache.read_lazy(root.get().prev).template set_field<&Node::next>(new_node);
+				root.template set_field<&Sentinel::prev>(new_node);
 			}
-			return iterator(root, std::move(new_node));
+			return iterator(root, cache, std::move(new_node));
 		});
 	}
 
@@ -174,11 +197,10 @@ public:
 			if (empty()) {
 				root.update([&](Sentinel& r) { r.next = r.prev = new_node; });
 			} else {
-				block_view<Node, CacheType> front = cache.read(root.get().next);
-				front.update([&](Node& n) { n.prev = new_node; });
-				root.update([&](Sentinel& r) { r.next = new_node; });
+				cache.read_lazy(root.get().next).template set_field<&Node::prev>(new_node);
+				root.template set_field<&Sentinel::next>(new_node);
 			}
-			return iterator(root, std::move(new_node));
+			return iterator(root, cache, std::move(new_node));
 		});
 	}
 
@@ -190,11 +212,11 @@ public:
 			return emplace_front(std::forward<decltype(args)>(args)...);
 		}
 		return cache.transaction([&] {
-			block_view<Node, CacheType> prev = cache.read(pos.curr.get().prev);
+			block_view_lazy<Node, CacheType> prev = cache.read_lazy(pos.curr.template get_field<&Node::prev>());
 			block_view<Node, CacheType> new_node = cache.create(pos.curr, prev, std::forward<decltype(args)>(args)...);
-			prev.update([&](Node& n) { n.next = new_node; });
-			pos.curr.update([&](Node& n) { n.prev = new_node; });
-			return iterator(root, std::move(new_node));
+			prev.template set_field<&Node::next>(new_node);
+			pos.curr.template set_field<&Node::prev>(new_node);
+			return iterator(root, cache, std::move(new_node));
 		});
 	}
 
@@ -203,13 +225,12 @@ public:
 			throw std::invalid_argument("list is empty");
 		}
 		return cache.transaction([&] {
-			block_view<Node, CacheType> back = cache.read(root.get().prev);
-			if (back.get().prev == root) {
+			block<Node> prev = cache.read_lazy(root.get().prev).template get_field<&Node::prev>();
+			if (prev == root) {
 				root.update([&](Sentinel& r) { r.next = r.prev = root; });
 			} else {
-				block_view<Node, CacheType> prev = cache.read(back.get().prev);
-				prev.update([&](Node& n) { n.next = root; });
-				root.update([&](Sentinel& r) { r.prev = prev; });
+				cache.read_lazy(prev).template set_field<&Node::next>(root);
+				root.template set_field<&Sentinel::prev>(prev);
 			}
 			return end();
 		});
@@ -220,15 +241,15 @@ public:
 			throw std::invalid_argument("list is empty");
 		}
 		return cache.transaction([&] {
-			block_view<Node, CacheType> front = cache.read(root.get().next);
-			if (front.get().next == root) {
+			block<Node> next = cache.read_lazy(root.get().next).template get_field<&Node::next>();
+			if (next == root) {
 				root.update([&](Sentinel& r) { r.next = r.prev = root; });
 				return end();
 			} else {
-				block_view<Node, CacheType> next = cache.read(front.get().next);
-				next.update([&](Node& n) { n.prev = root; });
-				root.update([&](Sentinel& r) { r.next = next; });
-				return iterator(root, std::move(next));
+				block_view_lazy<Node, CacheType> next_node = cache.read_lazy(std::move(next));
+				next_node.template set_field<&Node::prev>(root);
+				root.template set_field<&Sentinel::next>(next_node);
+				return iterator(root, cache, std::move(next_node));
 			}
 		});
 	}
@@ -237,18 +258,18 @@ public:
 		if (pos == end()) {
 			throw std::invalid_argument("list erase iterator outside range");
 		}
-		if (pos.curr.get().next == root) {
+		if (pos.curr.template get_field<&Node::next>() == root) {
 			return pop_back();
 		}
 		if (pos == begin()) {
 			return pop_front();
 		}
 		return cache.transaction([&] {
-			block_view<Node, CacheType> prev = cache.read(pos.curr.get().prev);
-			block_view<Node, CacheType> next = cache.read(pos.curr.get().next);
-			prev.update([&](Node& n) { n.next = next; });
-			next.update([&](Node& n) { n.prev = prev; });
-			return iterator(root, std::move(next));
+			block_view_lazy<Node, CacheType> prev = cache.read_lazy(pos.curr.template get_field<&Node::prev>());
+			block_view_lazy<Node, CacheType> next = cache.read_lazy(pos.curr.template get_field<&Node::next>());
+			prev.template set_field<&Node::next>(next);
+			next.template set_field<&Node::prev>(prev);
+			return iterator(root, cache, std::move(next));
 		});
 	}
 };
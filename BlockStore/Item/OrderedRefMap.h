@@ -33,8 +33,7 @@ private:
 
 public:
 	bool contains(const Key& key) const {
-		auto it = Base::lower_bound(key);
-		return it != Base::end() && key_cache.read((*it).first).get() == key;
+		return Base::contains(key);
 	}
 
 	bool equal(Base::iterator it, const Key& key) const {
@@ -31,8 +31,7 @@ protected:
 
 public:
 	bool contains(const Key& key) const {
-		auto it = Base::lower_bound(key);
-		return it != Base::end() && key_cache.read(*it).get() == key;
+		return Base::contains(key);
 	}
 
 	std::optional<block_view<Key, KeyCache>> compare(Base::iterator it, const Key& key) const {
@@ -6,6 +6,7 @@
 #include <cassert>
 #include <stdexcept>
 #include <algorithm>
+#include <optional>
 
 
 namespace BlockStore {
@@ -77,6 +78,15 @@ private:
 			return entry.first;
 		}
 	}
+	static Key key(const flat_view<LeafEntry>& entry) {
+		if constexpr (layout_trivial<LeafEntry>) {
+			return key(entry.get());
+		} else if constexpr (std::is_void_v<Value>) {
+			return Key(entry.get());
+		} else {
+			return Key(entry.first().get());
+		}
+	}
 
 private:
 	class node_iterator {
@@ -141,14 +151,26 @@ private:
 	private:
 		friend class Tree;
 	private:
-		leaf_iterator(LeafCache& leaf_cache, block_ref root) : node_iterator(), leaf_cache(nullptr), leaf_index(0), leaf(leaf_cache.read(std::move(root))) {}
-		leaf_iterator(node_iterator it, LeafCache& leaf_cache, size_t leaf_index) : node_iterator(std::move(it)), leaf_cache(&leaf_cache), leaf_index(leaf_index), leaf(leaf_cache.read(child_ref(node_iterator::get(), leaf_index))) {}
+		leaf_iterator(LeafCache& leaf_cache, block_ref root) : node_iterator(), leaf_cache(nullptr), leaf_index(0), prefetch_end(0), leaf(leaf_cache.read(std::move(root))) {}
+		leaf_iterator(node_iterator it, LeafCache& leaf_cache, size_t leaf_index) : node_iterator(std::move(it)), leaf_cache(&leaf_cache), leaf_index(leaf_index), prefetch_end(leaf_index + 1), leaf(leaf_cache.read(child_ref(node_iterator::get(), leaf_index))) {}
+	private:
+		constexpr static size_t prefetch_count = 16;
 	private:
 		LeafCache* leaf_cache;
 		size_t leaf_index;
+		size_t prefetch_end;
 		block_view<Leaf, LeafCache> leaf;
 	private:
 		bool is_root() const { return node_iterator::is_empty(); }
+		void prefetch() {
+			const Node& node = node_iterator::get();
+			prefetch_end = std::min(leaf_index + prefetch_count, keys(node).size() + 1);
+			std::vector<block<Leaf>> ref_list; ref_list.reserve(prefetch_end - leaf_index);
+			for (size_t index = leaf_index; index < prefetch_end; ++index) {
+				ref_list.emplace_back(child_ref(node, index));
+			}
+			leaf_cache->prefetch(ref_list);
+		}
 	protected:
 		bool operator==(const leaf_iterator& other) const { return leaf == other.leaf; }
 		const Leaf& get() const { return leaf.get(); }
@@ -161,8 +183,12 @@ private:
 			if (index > keys(node_iterator::get()).size()) {
 				node_iterator::next();
 				index = 0;
+				prefetch_end = 0;
 			}
 			leaf_index = index;
+			if (leaf_index >= prefetch_end) {
+				prefetch();
+			}
 			leaf = leaf_cache->read(child_ref(node_iterator::get(), leaf_index));
 		}
 		void prev() {
@@ -172,6 +198,7 @@ private:
 			if (leaf_index == 0) {
 				node_iterator::prev();
 				leaf_index = keys(node_iterator::get()).size();
+				prefetch_end = leaf_index + 1;
 			} else {
 				leaf_index--;
 			}
@@ -323,6 +350,21 @@ private:
 			}
 		}
 	}
+	block_ref find_leaf_ref(auto f) const {
+		size_t level = depth();
+		if (level == 0) {
+			return meta.get().first;
+		} else {
+			for (node_iterator it = root_node();;) {
+				size_t index = f(keys(it.get()));
+				if (--level > 0) {
+					it.child(index);
+				} else {
+					return child_ref(it.get(), index);
+				}
+			}
+		}
+	}
 	iterator find(leaf_iterator it, auto f) const {
 		size_t index = f(it.get());
 		return iterator(std::move(it), index);
@@ -367,6 +409,35 @@ public:
 		});
 	}
 
+public:
+	template<class K>
+	bool contains(const K& k) const {
+		bool separator = false;  // whether k equals the key separating the leaf from the previous one
+		block_ref leaf = find_leaf_ref([&](const NodeKeys& keys) {
+			size_t index = std::upper_bound(keys.begin(), keys.end(), k, [&](const K& k, const NodeEntry& entry) { return comp(k, key(entry)); }) - keys.begin();
+			if (index > 0) {
+				separator = !comp(key(keys[index - 1]), k);
+			}
+			return index;
+		});
+		std::optional<bool> found = leaf_cache.read_lazy(std::move(leaf)).inspect([&](const auto& leaf) -> std::optional<bool> {
+			size_t begin = 0, end = leaf.size();
+			while (begin < end) {
+				size_t middle = begin + (end - begin) / 2;
+				if (comp(key(leaf[middle]), k)) { begin = middle + 1; } else { end = middle; }
+			}
+			if (begin < leaf.size() && !comp(k, key(leaf[begin]))) {
+				return true;
+			}
+			return begin == 0 && separator ? std::nullopt : std::optional<bool>(false);
+		});
+		if (found.has_value()) {
+			return found.value();
+		}
+		iterator it = lower_bound(k), last = end();
+		return !(it == last) && !comp(k, key(*it));
+	}
+
 public:
 	void clear() {
 		if (depth() == 0) {
@@ -23,8 +23,7 @@ public:
 
 public:
 	bool contains(const block_ref& ref) const {
-		auto it = Base::lower_bound(ref);
-		return it != Base::end() && *it == ref;
+		return Base::contains(ref);
 	}
 
 	bool equal(Base::iterator it, const block_ref& ref) const {
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "type.h"
+
+#include <stdexcept>
+#include <chrono>
+
+
+namespace BlockStore {
+
+
+struct GroupCommitOption {
+	uint64 count_limit = 256;
+	std::chrono::milliseconds time_limit = std::chrono::milliseconds(10);
+
+	constexpr void check() const {
+		if (count_limit > 0 && time_limit.count() > 0) { return; }
+		throw std::invalid_argument("invalid group commit option");
+	}
+};
+
+
+} // namespace BlockStore
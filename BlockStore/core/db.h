@@ -5,6 +5,9 @@
 #include "SQLite3Helper/sqlite3_helper.h"
 
 #include <unordered_map>
+#include <optional>
+#include <algorithm>
+#include <string>
 #include <cassert>
 
 
@@ -16,7 +19,8 @@ using namespace CppSerialize;
 
 class DB : public Database {
 private:
-	constexpr static uint64 schema_version = 2026'02'20'00;
+	constexpr static uint64 schema_version = 2026'10'19'00;
+	constexpr static uint64 schema_version_unversioned_block = 2026'02'20'00;
 
 	struct Metadata {
 		uint64 version = schema_version;
@@ -27,6 +31,12 @@ private:
 	static_assert(layout_trivial<Metadata>);
 
 private:
+	Query pragma_journal_mode_wal = "pragma journal_mode = wal";  // void -> void
+
+	Query savepoint_nested = "savepoint nested";  // void -> void
+	Query release_nested = "release nested";  // void -> void
+	Query rollback_to_nested = "rollback to nested";  // void -> void
+
 	Query create_META = "create table META (data BLOB)";  // void -> void
 	Query create_BLOCK = "create table BLOCK (id INTEGER primary key, gc BOOLEAN, data BLOB, ref BLOB)";  // void -> void
 	Query create_SCAN = "create table SCAN (id INTEGER)";  // void -> void
@@ -38,7 +48,12 @@ private:
 	Query insert_id_BLOCK_gc = "insert into BLOCK (gc) values (?) returning id";  // gc: bool -> id: ref_t
 
 	Query select_data_BLOCK_id = "select data from BLOCK where id = ?";  // id: ref_t -> data: vector<byte>
+	Query select_data_BLOCK_id_list = "select BLOCK.data from json_each(cast(? as text)) as list left join BLOCK on BLOCK.id = list.value order by list.key";  // id_list: string -> vector<data: vector<byte>>
+	Query update_BLOCK_data_format = "update BLOCK set data = cast(x'00' || data as blob) where length(data) > 0";  // void -> void
 	Query update_BLOCK_data_ref_id = "update BLOCK set data = ?, ref = ? where id = ?";  // data: vector<byte>, ref: vector<ref_t>, id: ref_t -> void
+	Query update_BLOCK_data_id_range = "update BLOCK set data = cast(substr(data, 1, ?) || ? || substr(data, ?) as blob) where id = ? and substr(data, 1, 1) = x'00' and length(data) >= ?";  // begin: uint64, data: vector<byte>, end + 1: uint64, id: ref_t, end: uint64 -> void
+	Query select_ref_BLOCK_id_range = "select ref from BLOCK where id = ? and substr(data, 1, 1) = x'00' and length(data) >= ?";  // id: ref_t, end: uint64 -> ref: vector<ref_t>
+	Query update_BLOCK_data_ref_id_range = "update BLOCK set data = cast(substr(data, 1, ?) || ? || substr(data, ?) as blob), ref = ? where id = ?";  // begin: uint64, data: vector<byte>, end + 1: uint64, ref: vector<ref_t>, id: ref_t -> void
 
 	Query select_exists_SCAN = "select exists(select 1 from SCAN limit 1)";  // void -> exists: bool
 	Query update_ref_BLOCK_gc = "update BLOCK set gc = ? where id in (select id from SCAN order by rowid desc limit ?) and gc = ? returning ref";  // gc: bool, limit: uint64, gc: bool -> vector<ref: vector<ref_t>>
@@ -50,7 +65,7 @@ private:
 	Query delete_BLOCK_begin_end_gc = "delete from BLOCK where id in (select id from BLOCK where id >= ? and id < ? and gc = ?)";  // begin: ref_t, end: ref_t, gc: bool -> void
 
 public:
-	DB(const char file[]) : Database(file) {
+	DB(const char file[]) : Database(file), file(file), read_only(false) {
 		try {
 			this->metadata = Deserialize<Metadata>(ExecuteForOne<std::vector<byte>>(select_data_META)).Get();
 		} catch (...) {
@@ -66,15 +81,55 @@ public:
 			});
 			this->metadata = metadata;
 		}
+		if (this->metadata.version == schema_version_unversioned_block) {
+			Metadata metadata = this->metadata;
+			metadata.version = schema_version;
+			Transaction([&]() {
+				Execute(update_BLOCK_data_format);
+				ExecuteUpdateMetadata(metadata);
+			});
+			this->metadata = metadata;
+		}
 		if (this->metadata.version != schema_version) {
-			// upgrade
+			throw std::runtime_error("unsupported database version");
+		}
+	}
+	struct snapshot_tag {};
+	DB(const char file[], snapshot_tag) : Database(file), file(file), read_only(true) {
+		BeginTransaction();
+		this->metadata = Deserialize<Metadata>(ExecuteForOne<std::vector<byte>>(select_data_META)).Get();
+		if (this->metadata.version != schema_version) {
+			Rollback();
 			throw std::runtime_error("unsupported database version");
 		}
 	}
 	~DB() {
 		assert(active_ref_set.empty());
+		if (read_only) {
+			try { Commit(); } catch (...) {}  // only ends the read transaction of a snapshot
+		}
+	}
+
+private:
+	const std::string file;
+	const bool read_only;
+public:
+	const std::string& get_file() const { return file; }
+private:
+	void check_writable() const {
+		if (read_only) {
+			throw std::invalid_argument("snapshot is read-only");
+		}
 	}
 
+public:
+	void EnableWal() { if (!read_only) { Execute(pragma_journal_mode_wal); } }
+
+public:
+	void Savepoint() { Execute(savepoint_nested); }
+	void Release() { Execute(release_nested); }
+	void RollbackTo() { Execute(rollback_to_nested); Execute(release_nested); }
+
 private:
 	Metadata metadata;
 public:
@@ -91,6 +146,7 @@ private:
 	std::vector<ref_t> allocation_list;
 public:
 	ref_t allocate() {
+		check_writable();
 		if (allocation_list.empty()) {
 			Metadata metadata = this->metadata;
 			std::vector<ref_t> allocation_list; allocation_list.reserve(allocation_batch_size);
@@ -117,7 +173,7 @@ public:
 			it->second++;
 		} else {
 			active_ref_set.emplace(ref, 1);
-			if (metadata.gc.phase == GCPhase::Scanning) {
+			if (!read_only && metadata.gc.phase == GCPhase::Scanning) {
 				new_ref_list.push_back(ref);
 			}
 		}
@@ -136,15 +192,44 @@ public:
 	std::vector<byte> read(ref_t id) {
 		return ExecuteForOne<std::vector<byte>>(select_data_BLOCK_id, id);
 	}
+	std::vector<std::vector<byte>> read(const std::vector<ref_t>& id_list) {
+		std::string list = "[";
+		for (ref_t id : id_list) { list += std::to_string(id); list += ','; }
+		list.back() = ']';
+		if (id_list.empty()) { list += ']'; }
+		return ExecuteForMultiple<std::vector<byte>>(select_data_BLOCK_id_list, list);
+	}
 	void write(ref_t id, const std::vector<byte>& data, const std::vector<ref_t>& ref_list) {
+		check_writable();
 		Execute(update_BLOCK_data_ref_id, data, ref_list, id);
 	}
+	// only the given bytes and references are sent, but sqlite still rewrites the record of the block
+	bool write_range(ref_t id, uint64 offset, const std::vector<byte>& data, uint64 ref_offset, const std::vector<ref_t>& ref_list) {
+		check_writable();
+		uint64 end = offset + data.size();
+		if (ref_list.empty()) {
+			Execute(update_BLOCK_data_id_range, offset, data, end + 1, id, end);
+			return Changes() > 0;
+		}
+		bool written = false;
+		Transaction([&]() {
+			std::optional<std::vector<ref_t>> block_ref_list = ExecuteForOneOptional<std::vector<ref_t>>(select_ref_BLOCK_id_range, id, end);
+			if (!block_ref_list || block_ref_list->size() < ref_offset + ref_list.size()) {
+				return;
+			}
+			std::copy(ref_list.begin(), ref_list.end(), block_ref_list->begin() + ref_offset);
+			Execute(update_BLOCK_data_ref_id_range, offset, data, end + 1, *block_ref_list, id);
+			written = Changes() > 0;
+		});
+		return written;
+	}
 
 public:
 	const GCInfo& get_gc_info() {
 		return metadata.gc;
 	}
 	void gc(const GCOption& option) {
+		check_writable();
 		option.check();
 
 		Metadata metadata = this->metadata;
@@ -1,35 +1,786 @@
 #include "manager.h"
 #include "db.h"
+#include "worker.h"
+
+#include <map>
+#include <algorithm>
+#include <list>
+#include <unordered_set>
+#include <condition_variable>
+#include <thread>
 
 
 namespace BlockStore {
 
 
+struct BlockManager::OptimisticTransaction {
+	using WriteSet = std::map<ref_t, std::pair<std::vector<std::byte>, std::vector<ref_t>>>;
+
+	const BlockManager* manager;
+	OptimisticTransaction* outer;
+	uint64 start_stamp;
+	bool buffered = false;  // a transaction in the buffered mode, which holds the apply mutex and isn't validated
+	std::unordered_map<ref_t, uint64> read_set;  // with the earliest write stamp each block was read at
+	WriteSet write_set;
+	std::vector<WriteSet> nested_list;
+
+	void record_read(ref_t ref, uint64 stamp) {
+		if (buffered || write_set.contains(ref)) {
+			return;
+		}
+		auto [it, inserted] = read_set.try_emplace(ref, stamp);
+		if (!inserted) {
+			it->second = std::min(it->second, stamp);
+		}
+	}
+
+	static void release(DB& db, const WriteSet& write_set) {
+		for (auto& [ref, entry] : write_set) { for (ref_t child : entry.second) { db.dec_ref(child); } }
+	}
+	void begin_nested(DB& db) {
+		for (auto& [ref, entry] : write_set) { for (ref_t child : entry.second) { db.inc_ref(child); } }
+		nested_list.push_back(write_set);
+	}
+	void commit_nested(DB& db) {
+		release(db, nested_list.back());
+		nested_list.pop_back();
+	}
+	void rollback_nested(DB& db) {
+		release(db, write_set);
+		write_set = std::move(nested_list.back());
+		nested_list.pop_back();
+	}
+	void release(DB& db) {
+		release(db, write_set);
+		for (auto& nested : nested_list) { release(db, nested); }
+		nested_list.clear();
+	}
+};
+
+struct BlockManager::GroupCommit {
+	GroupCommitOption option;
+	bool open = false;
+	uint64 count = 0;
+	std::chrono::steady_clock::time_point begin;
+	std::promise<void> promise;
+	std::shared_future<void> future;
+	bool stop = false;
+	std::condition_variable_any condition;
+	std::thread thread;
+};
+
+
+struct BlockManager::RawCache {
+	using Entry = std::pair<ref_t, std::vector<std::byte>>;
+	constexpr static size_t entry_overhead = 4 * sizeof(Entry);
+
+	size_t byte_limit;
+	size_t bytes = 0;
+	std::list<Entry> list;
+	std::unordered_map<ref_t, std::list<Entry>::iterator> map;
+
+	const std::vector<std::byte>* find(ref_t ref) {
+		auto it = map.find(ref);
+		if (it == map.end()) {
+			return nullptr;
+		}
+		list.splice(list.begin(), list, it->second);
+		return &it->second->second;
+	}
+	void erase(ref_t ref) {
+		if (auto it = map.find(ref); it != map.end()) {
+			bytes -= entry_overhead + it->second->second.size();
+			list.erase(it->second);
+			map.erase(it);
+		}
+	}
+	void set(ref_t ref, const std::vector<std::byte>& data) {
+		erase(ref);
+		if (entry_overhead + data.size() > byte_limit) {
+			return;
+		}
+		list.emplace_front(ref, data);
+		map.emplace(ref, list.begin());
+		bytes += entry_overhead + data.size();
+		while (bytes > byte_limit) {
+			erase(list.back().first);
+		}
+	}
+	void clear() {
+		list.clear();
+		map.clear();
+		bytes = 0;
+	}
+};
+
+
+thread_local BlockManager::OptimisticTransaction* BlockManager::optimistic_transaction_stack = nullptr;
+
+
 BlockManager::BlockManager(const char file[]) : db(std::make_unique<DB>(file)) {}
 
-BlockManager::~BlockManager() {}
+BlockManager::BlockManager(std::unique_ptr<DB> db) : db(std::move(db)) {}
+
+BlockManager::~BlockManager() {
+	io_pool.reset();
+	try {
+		disable_group_commit();
+	} catch (...) {}
+}
+
+block_ref BlockManager::get_root() { std::lock_guard lock(mutex); return block_ref(*this, db->get_root()); }
+
+block_ref BlockManager::allocate() {
+	std::lock_guard lock(mutex);
+	ref_t ref = db->allocate();
+	if (raw_cache) {
+		raw_cache->erase(ref);
+	}
+	return block_ref(*this, ref);
+}
+
+std::unique_ptr<BlockManager> BlockManager::snapshot() {
+	std::lock_guard lock(mutex);
+	if (!wal) {
+		if (transaction_depth > 0) {
+			throw std::invalid_argument("cannot take the first snapshot inside a transaction");
+		}
+		commit_group();
+		db->EnableWal();
+		wal = true;
+	}
+	return std::unique_ptr<BlockManager>(new BlockManager(std::make_unique<DB>(db->get_file().c_str(), DB::snapshot_tag())));
+}
+
+void BlockManager::inc_ref(ref_t ref) { std::lock_guard lock(mutex); return db->inc_ref(ref); }
+
+void BlockManager::dec_ref(ref_t ref) { std::lock_guard lock(mutex); return db->dec_ref(ref); }
+
+std::vector<std::byte> BlockManager::read(ref_t ref) const {
+	if (OptimisticTransaction* transaction = current_optimistic_transaction()) {
+		if (auto it = transaction->write_set.find(ref); it != transaction->write_set.end()) {
+			return it->second.first;
+		}
+		transaction->record_read(ref, uint64(-1));
+	}
+	std::lock_guard lock(mutex);
+	if (raw_cache) {
+		if (const std::vector<std::byte>* data = raw_cache->find(ref)) {
+			return *data;
+		}
+		std::vector<std::byte> data = db->read(ref);
+		raw_cache->set(ref, data);
+		return data;
+	}
+	return db->read(ref);
+}
+
+std::vector<std::vector<std::byte>> BlockManager::read(const std::vector<ref_t>& ref_list) const {
+	std::vector<std::vector<std::byte>> data_list(ref_list.size());
+	std::vector<size_t> miss_list; miss_list.reserve(ref_list.size());
+	OptimisticTransaction* transaction = current_optimistic_transaction();
+	{
+		std::lock_guard lock(mutex);
+		for (size_t i = 0; i < ref_list.size(); ++i) {
+			if (transaction) {
+				if (auto it = transaction->write_set.find(ref_list[i]); it != transaction->write_set.end()) {
+					data_list[i] = it->second.first;
+					continue;
+				}
+				transaction->record_read(ref_list[i], uint64(-1));
+			}
+			if (raw_cache) {
+				if (const std::vector<std::byte>* data = raw_cache->find(ref_list[i])) {
+					data_list[i] = *data;
+					continue;
+				}
+			}
+			miss_list.push_back(i);
+		}
+	}
+	// the mutex is released between batches, so outside a transaction each batch may see a later state
+	for (size_t begin = 0; begin < miss_list.size(); begin += read_batch_size) {
+		size_t end = std::min(begin + read_batch_size, miss_list.size());
+		std::vector<ref_t> batch; batch.reserve(end - begin);
+		for (size_t i = begin; i < end; ++i) { batch.push_back(ref_list[miss_list[i]]); }
+		std::lock_guard lock(mutex);
+		std::vector<std::vector<std::byte>> result = db->read(batch);
+		if (result.size() != batch.size()) {
+			throw std::runtime_error("batch read size mismatch");
+		}
+		for (size_t i = begin; i < end; ++i) {
+			std::vector<std::byte>& data = data_list[miss_list[i]] = std::move(result[i - begin]);
+			if (raw_cache) {
+				raw_cache->set(ref_list[miss_list[i]], data);
+			}
+		}
+	}
+	return data_list;
+}
+
+uint64 BlockManager::write(ref_t ref, const std::vector<std::byte>& data, const std::vector<ref_t>& ref_list) {
+	if (OptimisticTransaction* transaction = current_optimistic_transaction()) {
+		std::lock_guard lock(mutex);
+		for (ref_t child : ref_list) { db->inc_ref(child); }
+		auto& entry = transaction->write_set[ref];
+		for (ref_t child : entry.second) { db->dec_ref(child); }
+		entry = std::make_pair(data, ref_list);
+		return stamp(ref);
+	}
+	std::unique_lock apply_lock(apply_mutex, std::defer_lock);
+	if (mode == transaction_mode::buffered) {
+		apply_lock.lock();  // a buffered transaction may have read the block
+	}
+	std::lock_guard lock(mutex);
+	return write_direct(ref, data, ref_list);
+}
+
+bool BlockManager::write_range(ref_t ref, size_t offset, const std::vector<std::byte>& data, size_t ref_offset, const std::vector<ref_t>& ref_list) {
+	if (current_optimistic_transaction()) {
+		return false;
+	}
+	std::unique_lock apply_lock(apply_mutex, std::defer_lock);
+	if (mode == transaction_mode::buffered) {
+		apply_lock.lock();
+	}
+	std::lock_guard lock(mutex);
+	if (raw_cache) {
+		raw_cache->erase(ref);
+	}
+	if (!db->write_range(ref, offset, data, ref_offset, ref_list)) {
+		return false;
+	}
+	uint64 current = stamp(ref);
+	if (!cache_list.empty()) {
+		notify_caches(ref);
+	}
+	if (optimistic_transaction_count > 0) {
+		write_sequence[ref] = current;
+	}
+	return true;
+}
+
+uint64 BlockManager::write_direct(ref_t ref, const std::vector<std::byte>& data, const std::vector<ref_t>& ref_list) {
+	db->write(ref, data, ref_list);
+	uint64 current = stamp(ref);
+	if (raw_cache) {
+		raw_cache->set(ref, data);
+	}
+	if (!cache_list.empty()) {
+		notify_caches(ref);
+	}
+	if (optimistic_transaction_count > 0) {
+		write_sequence[ref] = current;
+	}
+	return current;
+}
+
+uint64 BlockManager::stamp(ref_t ref) {
+	uint64 value = ++write_stamp_next;
+	write_stamp[ref % write_stamp_count].store(value, std::memory_order_release);
+	return value;
+}
+
+void BlockManager::stamp_all() {
+	uint64 value = ++write_stamp_next;
+	for (size_t i = 0; i < write_stamp_count; ++i) {
+		write_stamp[i].store(value, std::memory_order_release);
+	}
+}
+
+void BlockManager::begin_transaction() {
+	if (OptimisticTransaction* transaction = current_optimistic_transaction()) {
+		std::lock_guard lock(mutex);
+		transaction->begin_nested(*db);
+		return;
+	}
+	if (mode == transaction_mode::buffered) {
+		begin_buffered_transaction();
+	} else {
+		begin_exclusive_transaction();
+	}
+}
+
+void BlockManager::commit() {
+	if (OptimisticTransaction* transaction = current_optimistic_transaction()) {
+		if (transaction->buffered && transaction->nested_list.empty()) {
+			commit_buffered_transaction();
+			return;
+		}
+		std::lock_guard lock(mutex);
+		transaction->commit_nested(*db);
+		return;
+	}
+	commit_exclusive_transaction();
+}
+
+void BlockManager::rollback() {
+	if (OptimisticTransaction* transaction = current_optimistic_transaction()) {
+		if (transaction->buffered && transaction->nested_list.empty()) {
+			rollback_buffered_transaction();
+			return;
+		}
+		std::lock_guard lock(mutex);
+		for (auto& [ref, entry] : transaction->write_set) { stamp(ref); }
+		transaction->rollback_nested(*db);
+		return;
+	}
+	rollback_exclusive_transaction();
+}
+
+void BlockManager::begin_exclusive_transaction() {
+	mutex.lock();
+	if (transaction_depth == 0) {
+		try {
+			if (group_commit) {
+				begin_group();
+			} else {
+				db->BeginTransaction();
+			}
+		} catch (...) {
+			mutex.unlock();
+			throw;
+		}
+		transaction_owner = std::this_thread::get_id();
+	}
+	transaction_depth++;
+}
+
+void BlockManager::commit_exclusive_transaction() {
+	if (transaction_depth == 1) {
+		if (group_commit) {
+			db->Release();
+			try_commit_group();
+		} else {
+			db->Commit();
+		}
+	}
+	if (--transaction_depth == 0) {
+		transaction_owner = std::thread::id();
+		if (!group_commit) {
+			cache_written.clear();
+		}
+	}
+	mutex.unlock();
+}
+
+void BlockManager::rollback_exclusive_transaction() {
+	std::unique_lock lock(mutex, std::adopt_lock);
+	if (--transaction_depth == 0) {
+		transaction_owner = std::thread::id();
+		clear_raw_cache();
+		if (!group_commit) {
+			db->Rollback();
+		} else if (group_commit->open) {
+			db->RollbackTo();
+		}
+		stamp_all();
+		restore_caches(!group_commit);
+	}
+}
+
+void BlockManager::begin_buffered_transaction() {
+	std::unique_lock apply_lock(apply_mutex);
+	std::lock_guard lock(mutex);
+	optimistic_transaction_stack = new OptimisticTransaction{ this, optimistic_transaction_stack, write_stamp_next, true };
+	apply_lock.release();
+}
+
+void BlockManager::commit_buffered_transaction() {
+	OptimisticTransaction* transaction = optimistic_transaction_stack;
+	assert(transaction && transaction->manager == this && transaction->buffered);
+	{
+		std::lock_guard lock(mutex);
+		if (!transaction->write_set.empty()) {
+			apply(*transaction);  // on failure the transaction is left to be discarded by rollback()
+		}
+		transaction->release(*db);
+	}
+	optimistic_transaction_stack = transaction->outer;
+	delete transaction;
+	apply_mutex.unlock();
+}
+
+void BlockManager::rollback_buffered_transaction() {
+	std::unique_ptr<OptimisticTransaction> transaction(optimistic_transaction_stack);
+	assert(transaction && transaction->manager == this && transaction->buffered);
+	optimistic_transaction_stack = transaction->outer;
+
+	std::unique_lock apply_lock(apply_mutex, std::adopt_lock);
+	std::lock_guard lock(mutex);
+	for (auto& [ref, entry] : transaction->write_set) { stamp(ref); }
+	transaction->release(*db);
+}
+
+void BlockManager::set_transaction_mode(transaction_mode mode) {
+	std::lock_guard apply_lock(apply_mutex);
+	std::lock_guard lock(mutex);
+	if (transaction_depth > 0 || current_optimistic_transaction()) {
+		throw std::invalid_argument("cannot change the transaction mode inside a transaction");
+	}
+	this->mode = mode;
+}
+
+void BlockManager::begin_savepoint() {
+	if (OptimisticTransaction* transaction = current_optimistic_transaction()) {
+		std::lock_guard lock(mutex);
+		transaction->begin_nested(*db);
+		return;
+	}
+	if (mode == transaction_mode::buffered) {
+		begin_buffered_transaction();
+		return;
+	}
+	mutex.lock();
+	try {
+		if (transaction_depth == 0 && group_commit) {
+			begin_group();
+		} else if (transaction_depth == 0) {
+			db->BeginTransaction();
+		} else {
+			db->Savepoint();
+		}
+	} catch (...) {
+		mutex.unlock();
+		throw;
+	}
+	if (transaction_depth++ == 0) {
+		transaction_owner = std::this_thread::get_id();
+	}
+}
+
+void BlockManager::commit_savepoint() {
+	if (OptimisticTransaction* transaction = current_optimistic_transaction()) {
+		if (transaction->buffered && transaction->nested_list.empty()) {
+			commit_buffered_transaction();
+			return;
+		}
+		std::lock_guard lock(mutex);
+		transaction->commit_nested(*db);
+		return;
+	}
+	if (transaction_depth == 1 && !group_commit) {
+		db->Commit();
+	} else {
+		db->Release();
+		if (transaction_depth == 1) {
+			try_commit_group();
+		}
+	}
+	if (--transaction_depth == 0) {
+		transaction_owner = std::thread::id();
+		if (!group_commit) {
+			cache_written.clear();
+		}
+	}
+	mutex.unlock();
+}
+
+void BlockManager::rollback_savepoint() {
+	if (OptimisticTransaction* transaction = current_optimistic_transaction()) {
+		if (transaction->buffered && transaction->nested_list.empty()) {
+			rollback_buffered_transaction();
+			return;
+		}
+		std::lock_guard lock(mutex);
+		for (auto& [ref, entry] : transaction->write_set) { stamp(ref); }
+		transaction->rollback_nested(*db);
+		return;
+	}
+	std::unique_lock lock(mutex, std::adopt_lock);
+	if (--transaction_depth == 0) {
+		transaction_owner = std::thread::id();
+	}
+	clear_raw_cache();
+	if (transaction_depth == 0 && !group_commit) {
+		db->Rollback();
+	} else if (transaction_depth > 0 || group_commit->open) {
+		db->RollbackTo();
+	}
+	stamp_all();
+	restore_caches(transaction_depth == 0 && !group_commit);
+}
+
+BlockManager::OptimisticTransaction* BlockManager::current_optimistic_transaction() const {
+	for (OptimisticTransaction* transaction = optimistic_transaction_stack; transaction != nullptr; transaction = transaction->outer) {
+		if (transaction->manager == this) {
+			return transaction;
+		}
+	}
+	return nullptr;
+}
+
+void BlockManager::begin_optimistic_transaction() {
+	std::lock_guard lock(mutex);
+	optimistic_transaction_count++;
+	optimistic_transaction_stack = new OptimisticTransaction{ this, optimistic_transaction_stack, write_stamp_next };
+}
+
+bool BlockManager::commit_optimistic_transaction() {
+	std::unique_ptr<OptimisticTransaction> transaction(optimistic_transaction_stack);
+	assert(transaction && transaction->manager == this);
+	optimistic_transaction_stack = transaction->outer;
+
+	std::lock_guard apply_lock(apply_mutex);
+	std::lock_guard lock(mutex);
+	auto release = [&](bool discard) {
+		if (discard) {
+			for (auto& [ref, entry] : transaction->write_set) { stamp(ref); }
+		}
+		transaction->release(*db);
+		if (--optimistic_transaction_count == 0) {
+			write_sequence.clear();
+		}
+	};
+	// a block read from a cache may have been read before the transaction started
+	auto conflict = [&](ref_t ref, uint64 since) {
+		auto it = write_sequence.find(ref);
+		return it != write_sequence.end() && it->second > std::min(since, transaction->start_stamp);
+	};
+	for (auto& [ref, since] : transaction->read_set) {
+		if (conflict(ref, since)) { release(true); return false; }
+	}
+	for (auto& [ref, entry] : transaction->write_set) {
+		if (conflict(ref, uint64(-1))) { release(true); return false; }
+	}
+	try {
+		apply(*transaction);
+	} catch (...) {
+		release(true);
+		throw;
+	}
+	release(false);
+	return true;
+}
+
+void BlockManager::apply(const OptimisticTransaction& transaction) {
+	begin_exclusive_transaction();
+	try {
+		for (auto& [ref, entry] : transaction.write_set) {
+			write_direct(ref, entry.first, entry.second);
+		}
+		commit_exclusive_transaction();
+	} catch (...) {
+		rollback_exclusive_transaction();
+		throw;
+	}
+}
+
+void BlockManager::record_read(ref_t ref, uint64 stamp) const {
+	if (OptimisticTransaction* transaction = current_optimistic_transaction()) {
+		transaction->record_read(ref, stamp);
+	}
+}
+
+void BlockManager::rollback_optimistic_transaction() {
+	if (optimistic_transaction_stack == nullptr || optimistic_transaction_stack->manager != this) {
+		return;
+	}
+	std::unique_ptr<OptimisticTransaction> transaction(optimistic_transaction_stack);
+	optimistic_transaction_stack = transaction->outer;
+
+	std::lock_guard lock(mutex);
+	for (auto& [ref, entry] : transaction->write_set) { stamp(ref); }
+	transaction->release(*db);
+	if (--optimistic_transaction_count == 0) {
+		write_sequence.clear();
+	}
+}
+
+void BlockManager::begin_group() {
+	if (!group_commit->open) {
+		db->BeginTransaction();
+		group_commit->open = true;
+		group_commit->count = 0;
+		group_commit->begin = std::chrono::steady_clock::now();
+		group_commit->promise = std::promise<void>();
+		group_commit->future = group_commit->promise.get_future().share();
+		group_commit->condition.notify_all();
+	}
+	db->Savepoint();
+}
+
+void BlockManager::commit_group() {
+	if (!group_commit || !group_commit->open) {
+		return;
+	}
+	group_commit->open = false;
+	try {
+		db->Commit();
+	} catch (...) {
+		clear_raw_cache();
+		try { db->Rollback(); } catch (...) {}
+		stamp_all();
+		try { restore_caches(true); } catch (...) {}
+		group_commit->promise.set_exception(std::current_exception());
+		throw;
+	}
+	cache_written.clear();
+	group_commit->promise.set_value();
+}
+
+// called when an outermost transaction ends, which throws if it closes the group and the commit fails, with the group rolled back
+void BlockManager::try_commit_group() {
+	group_commit->count++;
+	if (group_commit->count >= group_commit->option.count_limit || std::chrono::steady_clock::now() - group_commit->begin >= group_commit->option.time_limit) {
+		commit_group();
+	}
+}
+
+void BlockManager::group_commit_loop() {
+	std::unique_lock lock(mutex);
+	while (!group_commit->stop) {
+		if (!group_commit->open) {
+			group_commit->condition.wait(lock);
+		} else if (auto deadline = group_commit->begin + group_commit->option.time_limit; std::chrono::steady_clock::now() < deadline) {
+			group_commit->condition.wait_until(lock, deadline);
+		} else {
+			try {
+				commit_group();
+			} catch (...) {}  // the error reaches the waiters through the promise
+		}
+	}
+}
+
+void BlockManager::enable_group_commit(const GroupCommitOption& option) {
+	option.check();
+	std::lock_guard lock(mutex);
+	if (transaction_depth > 0) {
+		throw std::invalid_argument("cannot change group commit inside a transaction");
+	}
+	if (group_commit) {
+		group_commit->option = option;
+		group_commit->condition.notify_all();
+		return;
+	}
+	group_commit = std::make_unique<GroupCommit>();
+	group_commit->option = option;
+	group_commit->thread = std::thread([this]() { group_commit_loop(); });
+}
+
+void BlockManager::disable_group_commit() {
+	std::unique_lock lock(mutex);
+	if (!group_commit) {
+		return;
+	}
+	if (transaction_depth > 0) {
+		throw std::invalid_argument("cannot change group commit inside a transaction");
+	}
+	group_commit->stop = true;
+	group_commit->condition.notify_all();
+	lock.unlock();
+	group_commit->thread.join();
+	lock.lock();
+	try {
+		commit_group();
+	} catch (...) {
+		group_commit.reset();
+		throw;
+	}
+	group_commit.reset();
+}
+
+std::shared_future<void> BlockManager::pending_commit() {
+	std::lock_guard lock(mutex);
+	if (group_commit && group_commit->open) {
+		return group_commit->future;
+	}
+	std::promise<void> promise; promise.set_value();
+	return promise.get_future().share();
+}
+
+void BlockManager::flush() {
+	std::lock_guard lock(mutex);
+	if (!group_commit) {
+		return;
+	}
+	commit_group();
+}
+
+void BlockManager::clear_raw_cache() {
+	if (raw_cache) {
+		raw_cache->clear();
+	}
+}
 
-block_ref BlockManager::get_root() { return block_ref(*this, db->get_root()); }
+void BlockManager::enable_raw_cache(size_t byte_limit) {
+	if (byte_limit == 0) {
+		throw std::invalid_argument("invalid raw cache limit");
+	}
+	std::lock_guard lock(mutex);
+	if (!raw_cache) {
+		raw_cache = std::make_unique<RawCache>();
+	}
+	raw_cache->byte_limit = byte_limit;
+	while (raw_cache->bytes > byte_limit) {
+		raw_cache->erase(raw_cache->list.back().first);
+	}
+}
 
-block_ref BlockManager::allocate() { return block_ref(*this, db->allocate()); }
+void BlockManager::disable_raw_cache() {
+	std::lock_guard lock(mutex);
+	raw_cache.reset();
+}
 
-void BlockManager::inc_ref(ref_t ref) { return db->inc_ref(ref); }
+void BlockManager::notify_caches(ref_t ref) {
+	if (transaction_depth > 0 || (group_commit && group_commit->open)) {
+		cache_written.insert(ref);
+	}
+	for (CoherentCache* cache : cache_list) {
+		cache->notify(ref);
+	}
+}
 
-void BlockManager::dec_ref(ref_t ref) { return db->dec_ref(ref); }
+void BlockManager::restore_caches(bool release) {
+	if (cache_written.empty()) {
+		return;
+	}
+	for (ref_t ref : cache_written) {
+		for (CoherentCache* cache : cache_list) {
+			cache->notify(ref);
+		}
+	}
+	if (release) {
+		cache_written.clear();
+	}
+}
 
-std::vector<std::byte> BlockManager::read(ref_t ref) const { return db->read(ref); }
+void BlockManager::register_cache(CoherentCache& cache) {
+	std::lock_guard lock(mutex);
+	if (std::find(cache_list.begin(), cache_list.end(), &cache) == cache_list.end()) {
+		cache_list.push_back(&cache);
+	}
+}
 
-void BlockManager::write(ref_t ref, const std::vector<std::byte>& data, const std::vector<ref_t>& ref_list) { return db->write(ref, data, ref_list); }
+void BlockManager::unregister_cache(CoherentCache& cache) {
+	std::lock_guard lock(mutex);
+	std::erase(cache_list, &cache);
+}
 
-void BlockManager::begin_transaction() { db->BeginTransaction(); }
+bool BlockManager::run_inline() const {
+	return io_thread_count == 0 || transaction_owner == std::this_thread::get_id() || current_optimistic_transaction() != nullptr;
+}
 
-void BlockManager::commit() { db->Commit(); }
+void BlockManager::submit(std::function<void()> task) const {
+	std::lock_guard lock(mutex);
+	if (!io_pool) {
+		io_pool = std::make_unique<WorkerPool>(io_thread_count);
+	}
+	io_pool->submit(std::move(task));
+}
 
-void BlockManager::rollback() { db->Rollback(); }
+void BlockManager::set_io_thread_count(size_t count) {
+	std::unique_ptr<WorkerPool> io_pool;
+	{
+		std::lock_guard lock(mutex);
+		io_thread_count = count;
+		io_pool = std::move(this->io_pool);
+	}
+}
 
-const GCInfo& BlockManager::get_gc_info() { return db->get_gc_info(); }
+const GCInfo& BlockManager::get_gc_info() { std::lock_guard lock(mutex); return db->get_gc_info(); }
 
-void BlockManager::gc(const GCOption& option) { return db->gc(option); }
+void BlockManager::gc(const GCOption& option) { std::lock_guard lock(mutex); commit_group(); return db->gc(option); }
 
 
 } // namespace BlockStore
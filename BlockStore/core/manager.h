@@ -2,41 +2,126 @@
 
 #include "ref.h"
 #include "gc.h"
+#include "commit.h"
 
 #include <memory>
+#include <future>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <unordered_map>
+#include <unordered_set>
 
 
 namespace BlockStore {
 
 class DB;
+class WorkerPool;
+
+
+// a cache told of the blocks written through its manager, which it applies on its own thread at its next access
+class CoherentCache {
+private:
+	friend class BlockManager;
+private:
+	constexpr static size_t written_limit = 4096;  // beyond which the cache checks all its entries instead
+private:
+	std::mutex written_mutex;
+	std::vector<ref_t> written;
+	bool written_all = false;
+	std::atomic<bool> pending = false;
+private:
+	void notify(ref_t ref) {
+		std::lock_guard lock(written_mutex);
+		if (written.size() < written_limit) {
+			written.push_back(ref);
+		} else {
+			written_all = true;
+		}
+		pending.store(true, std::memory_order_release);
+	}
+protected:
+	virtual ~CoherentCache() {}
+	bool has_written() const { return pending.load(std::memory_order_acquire); }
+	std::pair<std::vector<ref_t>, bool> take_written() {
+		std::lock_guard lock(written_mutex);
+		pending.store(false, std::memory_order_relaxed);
+		return { std::exchange(written, {}), std::exchange(written_all, false) };
+	}
+};
 
 
 class BlockManager {
 public:
 	BlockManager(const char file[]);
 	~BlockManager();
+private:
+	BlockManager(std::unique_ptr<DB> db);
 
 private:
 	std::unique_ptr<DB> db;
+	mutable std::recursive_mutex mutex;
 public:
 	block_ref get_root();
 	block_ref allocate();
 
+	// snapshot
+private:
+	bool wal = false;
+public:
+	std::unique_ptr<BlockManager> snapshot();
+
 private:
 	friend class block_ref;
+private:
+	constexpr static size_t read_batch_size = 256;
 private:
 	void inc_ref(ref_t ref);
 	void dec_ref(ref_t ref);
 private:
 	std::vector<std::byte> read(ref_t ref) const;
-	void write(ref_t ref, const std::vector<std::byte>& data, const std::vector<ref_t>& ref_list);
+	std::vector<std::vector<std::byte>> read(const std::vector<ref_t>& ref_list) const;
+	uint64 write(ref_t ref, const std::vector<std::byte>& data, const std::vector<ref_t>& ref_list);
+	bool write_range(ref_t ref, size_t offset, const std::vector<std::byte>& data, size_t ref_offset, const std::vector<ref_t>& ref_list);
+
+	// write stamp
+private:
+	constexpr static size_t write_stamp_count = 4096;
+	uint64 write_stamp_next = 0;
+	std::unique_ptr<std::atomic<uint64>[]> write_stamp = std::make_unique<std::atomic<uint64>[]>(write_stamp_count);
+private:
+	uint64 stamp(ref_t ref);
+	void stamp_all();
+public:
+	// changes whenever the block, or another block sharing its slot, is written or a write is rolled back
+	uint64 get_write_stamp(ref_t ref) const { return write_stamp[ref % write_stamp_count].load(std::memory_order_acquire); }
 
 	// transaction
+private:
+	size_t transaction_depth = 0;
+	std::atomic<std::thread::id> transaction_owner;
+	std::atomic<transaction_mode> mode = transaction_mode::exclusive;
+	mutable std::recursive_mutex apply_mutex;  // held by buffered transactions for their body, and while applying buffered writes
+private:
+	void begin_exclusive_transaction();
+	void commit_exclusive_transaction();
+	void rollback_exclusive_transaction();
+	void begin_buffered_transaction();
+	void commit_buffered_transaction();
+	void rollback_buffered_transaction();
 protected:
 	void begin_transaction();
 	void commit();
 	void rollback();
+	void begin_savepoint();
+	void commit_savepoint();
+	void rollback_savepoint();
 public:
+	bool in_transaction() const { return transaction_owner == std::this_thread::get_id() || current_optimistic_transaction() != nullptr; }
+	// in the buffered mode, writes of a transaction are kept by its thread and applied at the end, so other threads can read meanwhile
+	void set_transaction_mode(transaction_mode mode);
+	transaction_mode get_transaction_mode() const { return mode; }
 	decltype(auto) transaction(auto f) {
 		begin_transaction();
 		try {
@@ -53,6 +138,137 @@ public:
 			throw;
 		}
 	}
+	decltype(auto) savepoint(auto f) {
+		begin_savepoint();
+		try {
+			if constexpr (std::is_void_v<std::invoke_result_t<decltype(f)>>) {
+				f();
+				commit_savepoint();
+			} else {
+				decltype(auto) res = f();
+				commit_savepoint();
+				return res;
+			}
+		} catch (...) {
+			rollback_savepoint();
+			throw;
+		}
+	}
+
+	// optimistic transaction
+private:
+	struct OptimisticTransaction;
+	static thread_local OptimisticTransaction* optimistic_transaction_stack;
+private:
+	size_t optimistic_transaction_count = 0;
+	std::unordered_map<ref_t, uint64> write_sequence;  // the stamp of the last write of each block while optimistic transactions are running
+private:
+	OptimisticTransaction* current_optimistic_transaction() const;
+	uint64 write_direct(ref_t ref, const std::vector<std::byte>& data, const std::vector<ref_t>& ref_list);
+	void apply(const OptimisticTransaction& transaction);
+public:
+	// for reads served by a cache, with the write stamp the object was read at
+	void record_read(ref_t ref, uint64 stamp) const;
+protected:
+	void begin_optimistic_transaction();
+	bool commit_optimistic_transaction();
+	void rollback_optimistic_transaction();
+public:
+	decltype(auto) optimistic_transaction(auto f) {
+		if (current_optimistic_transaction()) {
+			return f();
+		}
+		for (;;) {
+			begin_optimistic_transaction();
+			try {
+				if constexpr (std::is_void_v<std::invoke_result_t<decltype(f)>>) {
+					f();
+					if (commit_optimistic_transaction()) {
+						return;
+					}
+				} else {
+					decltype(auto) res = f();
+					if (commit_optimistic_transaction()) {
+						return res;
+					}
+				}
+			} catch (...) {
+				rollback_optimistic_transaction();
+				throw;
+			}
+		}
+	}
+
+	// group commit
+private:
+	struct GroupCommit;
+	std::unique_ptr<GroupCommit> group_commit;
+private:
+	void begin_group();
+	void commit_group();
+	void try_commit_group();
+	void group_commit_loop();
+public:
+	void enable_group_commit(const GroupCommitOption& option);
+	void disable_group_commit();
+	std::shared_future<void> pending_commit();
+	void flush();
+
+	// raw cache
+private:
+	struct RawCache;
+	std::unique_ptr<RawCache> raw_cache;
+private:
+	void clear_raw_cache();
+public:
+	void enable_raw_cache(size_t byte_limit);
+	void disable_raw_cache();
+
+	// cache registry
+private:
+	std::vector<CoherentCache*> cache_list;
+	std::unordered_set<ref_t> cache_written;
+	std::atomic<uint64> discarded_write_count = 0;
+private:
+	void notify_caches(ref_t ref);
+	void restore_caches(bool release);
+public:
+	void register_cache(CoherentCache& cache);
+	void unregister_cache(CoherentCache& cache);
+	// counts the changed blocks of caches destroyed without being able to write them
+	void discard_writes(size_t count) { discarded_write_count.fetch_add(count, std::memory_order_relaxed); }
+	uint64 get_discarded_write_count() const { return discarded_write_count.load(std::memory_order_relaxed); }
+
+	// format
+private:
+	std::atomic<block_format> format = block_format::fixed;
+	std::atomic<block_compression> compression = block_compression::none;
+public:
+	void set_block_format(block_format format) { this->format = format; }
+	block_format get_block_format() const { return format; }
+	void set_block_compression(block_compression compression) { this->compression = compression; }
+	block_compression get_block_compression() const { return compression; }
+
+	// async
+private:
+	std::atomic<size_t> io_thread_count = 4;
+	mutable std::unique_ptr<WorkerPool> io_pool;  // created at the first submission, guarded by the mutex
+private:
+	bool run_inline() const;
+	void submit(std::function<void()> task) const;
+public:
+	void set_io_thread_count(size_t count);
+	auto run_async(auto f) const {
+		using Result = std::invoke_result_t<decltype(f)>;
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::move(f));
+		std::future<Result> future = task->get_future();
+		if (run_inline()) {
+			(*task)();
+		} else {
+			submit([task]() { (*task)(); });
+		}
+		return future;
+	}
 
 	// gc
 public:
@@ -25,7 +25,13 @@ void block_ref::check() const { if (manager == nullptr) { throw std::invalid_arg
 
 std::vector<std::byte> block_ref::read() const { check(); return manager->read(ref); }
 
-void block_ref::write(const std::vector<std::byte>& data, const std::vector<ref_t>& ref_list) { check(); return manager->write(ref, data, ref_list); }
+std::future<std::vector<std::byte>> block_ref::read_async() const { check(); return manager->run_async([ref = *this]() { return ref.read(); }); }
+
+std::vector<std::vector<std::byte>> block_ref::read_batch(BlockManager& manager, const std::vector<ref_t>& ref_list) { return manager.read(ref_list); }
+
+uint64 block_ref::write(const std::vector<std::byte>& data, const std::vector<ref_t>& ref_list) { check(); return manager->write(ref, data, ref_list); }
+
+bool block_ref::write_range(size_t offset, const std::vector<std::byte>& data, size_t ref_offset, const std::vector<ref_t>& ref_list) { check(); return manager->write_range(ref, offset, data, ref_offset, ref_list); }
 
 
 } // namespace BlockStore
@@ -3,6 +3,7 @@
 #include "type.h"
 
 #include <vector>
+#include <future>
 
 
 namespace BlockStore {
@@ -34,7 +35,10 @@ public:
 	operator ref_t() const { check(); return ref; }
 public:
 	std::vector<std::byte> read() const;
-	void write(const std::vector<std::byte>& data, const std::vector<ref_t>& ref_list);
+	std::future<std::vector<std::byte>> read_async() const;
+	static std::vector<std::vector<std::byte>> read_batch(BlockManager& manager, const std::vector<ref_t>& ref_list);
+	uint64 write(const std::vector<std::byte>& data, const std::vector<ref_t>& ref_list);  // returns the write stamp
+	bool write_range(size_t offset, const std::vector<std::byte>& data, size_t ref_offset, const std::vector<ref_t>& ref_list);
 };
 
 
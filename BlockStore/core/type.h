@@ -7,5 +7,9 @@ namespace BlockStore {
 using uint64 = unsigned long long;
 using ref_t = uint64;
 
+enum class block_format : unsigned char { fixed, compact };
+enum class block_compression : unsigned char { none, lz };
+enum class transaction_mode : unsigned char { exclusive, buffered };
+
 
 } // namespace BlockStore
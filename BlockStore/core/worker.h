@@ -0,0 +1,65 @@
+#pragma once
+
+#include <functional>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+
+namespace BlockStore {
+
+
+class WorkerPool {
+public:
+	WorkerPool(size_t thread_count) {
+		thread_list.reserve(thread_count);
+		for (size_t i = 0; i < thread_count; ++i) {
+			thread_list.emplace_back([this]() { run(); });
+		}
+	}
+	~WorkerPool() {
+		{
+			std::lock_guard lock(mutex);
+			stop = true;
+		}
+		condition.notify_all();
+		for (auto& thread : thread_list) {
+			thread.join();
+		}
+	}
+
+private:
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<std::function<void()>> task_list;
+	bool stop = false;
+	std::vector<std::thread> thread_list;
+private:
+	void run() {
+		for (;;) {
+			std::function<void()> task;
+			{
+				std::unique_lock lock(mutex);
+				condition.wait(lock, [&]() { return stop || !task_list.empty(); });
+				if (task_list.empty()) {
+					return;
+				}
+				task = std::move(task_list.front()); task_list.pop_front();
+			}
+			task();
+		}
+	}
+public:
+	void submit(std::function<void()> task) {
+		{
+			std::lock_guard lock(mutex);
+			task_list.emplace_back(std::move(task));
+		}
+		condition.notify_one();
+	}
+};
+
+
+} // namespace BlockStore
@@ -1,11 +1,33 @@
 #pragma once
 
 #include "serializer.h"
+#include "digest.h"
+#include "../core/manager.h"
 
 
 namespace BlockStore {
 
-constexpr size_t block_size_limit = 4096; // byte
+constexpr size_t block_size_limit = 4096; // byte, excluding the format header
+
+
+inline size_t serialized_size(const auto& object, block_format format = block_format::fixed) {
+	return SizeContext(format).access(object).Get().first;
+}
+
+
+// the digest of the data of a block as last read or written, valid while the write stamp of the block is unchanged
+struct block_stored {
+	block_digest digest = {};
+	uint64 stamp = 0;
+	size_t size = 0;
+	bool valid = false;
+
+	void reset() { valid = false; }
+	bool same(const std::vector<std::byte>& data) const { return valid && digest == BlockStore::digest(data); }
+	bool matches(BlockManager& manager, ref_t ref, const block_digest& digest) const {
+		return valid && stamp == manager.get_write_stamp(ref) && this->digest == digest;
+	}
+};
 
 
 template<class T>
@@ -39,12 +61,101 @@ public:
 			return DeserializeContext(get_manager(), std::move(data)).access<T>();
 		}
 	}
-	void write(const T& object) {
-		auto [data, ref_list] = SerializeContext(get_manager()).access(object).Get();
-		if (data.size() > block_size_limit) {
+	template<auto member>
+	auto read_field() const {
+		using Field = std::remove_cvref_t<decltype(std::declval<const T&>().*member)>;
+		constexpr size_t offset = T::layout_members::template offset<member>();
+		if (auto data = block_ref::read(); data.empty()) {
+			throw std::invalid_argument("block data uninitialized");
+		} else {
+			DeserializeContext context(get_manager(), std::move(data));
+			if (context.GetFormat() == block_format::fixed) {
+				return context.skip(offset).access<Field>();
+			} else {
+				return Field(std::move(context.access<T>().*member));
+			}
+		}
+	}
+	T read_stored(block_stored& stored) const {
+		uint64 stamp = get_manager().get_write_stamp(*this);
+		return read_stored(block_ref::read(), stamp, stored);
+	}
+	T read_stored(std::vector<std::byte> data, uint64 stamp, block_stored& stored) const {
+		if (data.empty()) {
+			throw std::invalid_argument("block data uninitialized");
+		} else {
+			block_digest digest = BlockStore::digest(data); size_t size = data.size();
+			T object = DeserializeContext(get_manager(), std::move(data)).access<T>();
+			stored = block_stored{ digest, stamp, size, true };
+			return object;
+		}
+	}
+	size_t serialized_size(const T& object) const {
+		return BlockStore::serialized_size(object, get_manager().get_block_format());
+	}
+	std::future<T> read_async() const {
+		return get_manager().run_async([ref = *this]() { return ref.read(); });
+	}
+private:
+	std::pair<std::vector<std::byte>, std::vector<ref_t>> serialize(const T& object) const {
+		if constexpr (flat_layout<T>::is_static) {
+			static_assert(flat_layout<T>::size <= block_size_limit, "block size exceeds limit");
+		}
+		block_format format = get_manager().get_block_format();
+		auto [size, ref_size] = SizeContext(format).access(object).Get();
+		if (size > block_size_limit && format == block_format::fixed) {
+			// keep blocks sized for the compact format, like tree nodes split in it, in that format
+			if (size_t compact_size = SizeContext(block_format::compact).access(object).Get().first; compact_size < size) {
+				format = block_format::compact; size = compact_size;
+			}
+		}
+		if (size > block_size_limit && get_manager().get_block_compression() == block_compression::none) {
 			throw std::invalid_argument("block size exceeds limit");
 		}
+		auto [data, ref_list] = SerializeContext(get_manager(), format, size, ref_size).access(object).Get();
+		if (data.size() > block_size_limit + 1) {
+			SerializeContext::Recycle(std::move(data), std::move(ref_list));
+			throw std::invalid_argument("block size exceeds limit");
+		}
+		return { std::move(data), std::move(ref_list) };
+	}
+public:
+	size_t write(const T& object) {
+		auto [data, ref_list] = serialize(object);
+		size_t size = data.size();
 		block_ref::write(data, ref_list);
+		SerializeContext::Recycle(std::move(data), std::move(ref_list));
+		return size;
+	}
+	std::pair<bool, size_t> write_changed(const T& object, block_stored& stored) {
+		auto [data, ref_list] = serialize(object);
+		size_t size = data.size();
+		block_digest digest = BlockStore::digest(data);
+		bool changed = !stored.matches(get_manager(), *this, digest);
+		if (changed) {
+			stored.valid = false;
+			stored.stamp = block_ref::write(data, ref_list);
+			stored.digest = digest;
+			stored.size = size;
+			stored.valid = true;
+		}
+		SerializeContext::Recycle(std::move(data), std::move(ref_list));
+		return { changed, size };
+	}
+	template<auto member>
+	bool write_field(const auto& value) {
+		using Field = std::remove_cvref_t<decltype(std::declval<const T&>().*member)>;
+		static_assert(flat_layout<Field>::is_static);
+		constexpr size_t offset = T::layout_members::template offset<member>();
+		constexpr size_t ref_offset = T::layout_members::template ref_offset<member>();
+		if (get_manager().get_block_format() != block_format::fixed || get_manager().get_block_compression() != block_compression::none) {
+			return false;
+		}
+		const Field& field = value;
+		std::vector<std::byte> data(flat_layout<Field>::size); std::byte* data_it = data.data();
+		std::vector<ref_t> ref_list(flat_layout<Field>::ref_size); ref_t* ref_it = ref_list.data();
+		static_codec::encode(get_manager(), field, data_it, ref_it);
+		return block_ref::write_range(1 + offset, data, ref_offset, ref_list);
 	}
 };
 
@@ -1,12 +1,19 @@
 #pragma once
 
 #include "block.h"
+#include "view.h"
+#include "stats.h"
+#include "manifest.h"
 #include "../core/manager.h"
 
 #include <unordered_map>
 #include <unordered_set>
-#include <any>
+#include <atomic>
+#include <memory>
 #include <optional>
+#include <chrono>
+#include <span>
+#include <algorithm>
 
 
 namespace BlockStore {
@@ -37,11 +44,14 @@ private:
 	block<T>::read;
 	block<T>::write;
 public:
-	const T& get() const { if (object == nullptr) { object = &cache->lookup_read(*this); } return *object; }
-	const T& get(auto init) const { if (object == nullptr) { object = &cache->lookup_read(*this, std::forward<decltype(init)>(init)); } return *object; }
+	const T& get() const { if (object == nullptr) { object = &cache->lookup_read(*this); } else { cache->revisit(*this); } return *object; }
+	const T& get(auto init) const { if (object == nullptr) { object = &cache->lookup_read(*this, std::forward<decltype(init)>(init)); } else { cache->revisit(*this); } return *object; }
+	template<auto member> auto get_field() const { if (object != nullptr) { cache->revisit(*this); return object->*member; } else if (const T* cached = cache->find(*this)) { return cached->*member; } else { return block<T>::template read_field<member>(); } }
+	decltype(auto) inspect(auto f) const { if (object != nullptr) { cache->revisit(*this); return f(*object); } else if (const T* cached = cache->find(*this)) { return f(*cached); } else { return block_view_bytes<T>(*this).inspect(f); } }
 	const T& set(auto&&... args) { if (object == nullptr) { object = &cache->lookup_write(*this, std::forward<decltype(args)>(args)...); return *object; } else { return cache->update(*this, *object, [&](T& object) { object = T(std::forward<decltype(args)>(args)...); }); } }
 	const T& update(auto f) { return cache->update(*this, get(), std::forward<decltype(f)>(f)); }
 	const T& update(auto f, auto init) { return cache->update(*this, get(std::forward<decltype(init)>(init)), std::forward<decltype(f)>(f)); }
+	template<auto member> void set_field(const auto& value) { cache->template update_field<member>(*this, value); }
 };
 
 template<class T, class CacheType>
@@ -59,10 +69,211 @@ public:
 };
 
 
+template<class T, class CacheType>
+class block_view_future {
+private:
+	friend CacheType;
+private:
+	block_view_future(block<T> ref, CacheType& cache, std::future<T> future) : ref(std::move(ref)), cache(&cache), future(std::move(future)) {}
+private:
+	block<T> ref;
+	CacheType* cache;
+	std::future<T> future;
+public:
+	bool ready() const { return !future.valid() || future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+	void wait() const { if (future.valid()) { future.wait(); } }
+	block_view<T, CacheType> get() { return cache->complete_read(std::move(ref), std::move(future)); }
+};
+
+
+// the read of the next block of a sequence, started while the current one is used, which copies don't share
+template<class T, class CacheType>
+class block_read_ahead {
+public:
+	block_read_ahead() = default;
+	block_read_ahead(const block_read_ahead&) {}
+	block_read_ahead(block_read_ahead&&) = default;
+	block_read_ahead& operator=(const block_read_ahead&) { reset(); return *this; }
+	block_read_ahead& operator=(block_read_ahead&&) = default;
+private:
+	block<T> ref;
+	uint64 stamp = 0;
+	std::optional<block_view_future<T, CacheType>> future;
+public:
+	void start(CacheType& cache, const block<T>& ref) {
+		if (future) {
+			return;
+		}
+		this->ref = ref;
+		stamp = ref.get_manager().get_write_stamp(ref);
+		future.emplace(cache.read_async(ref));
+	}
+	// the view of the block if it is the one read ahead and was not written since
+	std::optional<block_view<T, CacheType>> take(const block<T>& ref) {
+		std::optional<block_view_future<T, CacheType>> future = std::exchange(this->future, std::nullopt);
+		if (future && this->ref == ref && ref.get_manager().get_write_stamp(ref) == stamp) {
+			return future->get();
+		}
+		return std::nullopt;
+	}
+	void reset() { future.reset(); }
+};
+
+
+struct CacheOption {
+	size_t entry_limit = 0;  // 0 for unlimited
+	size_t byte_limit = 0;  // 0 for unlimited, estimated by the entries and the serialized sizes of their objects
+	bool coherent = false;
+
+	constexpr void check() const {
+		if (byte_limit == 0 || byte_limit >= block_size_limit) { return; }
+		throw std::invalid_argument("invalid cache option");
+	}
+};
+
+
+struct WriteBackOption {
+	uint64 count_limit = 1024;
+	uint64 byte_limit = 4 * 1024 * 1024;
+	std::chrono::milliseconds time_limit = std::chrono::milliseconds(1000);  // checked when the cache is used, there is no timer to flush an idle cache
+
+	constexpr void check() const {
+		if (count_limit > 0 && byte_limit > 0 && time_limit.count() > 0) { return; }
+		throw std::invalid_argument("invalid write back option");
+	}
+};
+
+
+template<class Entry>
+class CacheClock {
+public:
+	CacheClock(std::unordered_map<ref_t, Entry>& map, const std::unordered_set<ref_t>& dirty, CacheCounters& counters, const CacheOption& option) : map(map), dirty(dirty), counters(counters), option((option.check(), option)) {}
+private:
+	std::unordered_map<ref_t, Entry>& map;
+	const std::unordered_set<ref_t>& dirty;
+	CacheCounters& counters;
+	const CacheOption option;
+	constexpr static ref_t empty_slot = ref_t(-1);
+	std::vector<ref_t> ring;
+	std::vector<size_t> free;  // slots of erased entries, the last one just behind the hand after an eviction
+	size_t count = 0;
+	size_t hand = 0;
+	size_t bytes = 0;
+public:
+	// an entry is counted with its map node, and its object by the size of its data, which stands for the memory the object owns
+	constexpr static size_t entry_size = sizeof(typename std::unordered_map<ref_t, Entry>::value_type) + 2 * sizeof(void*);
+	// the size is known for objects read or written with their data, and only the others are walked
+	size_t measure(const auto& object, const block_stored& stored, size_t object_size = 0) const {
+		return entry_size + object_size + (stored.valid ? stored.size : serialized_size(object));
+	}
+	size_t size() const { return count; }
+	size_t byte_size() const { return bytes; }
+	void insert(Entry& entry) {
+		// a new entry takes the slot last freed, so the hand goes around the ring once before reaching it
+		if (free.empty()) {
+			free.push_back(ring.size()); ring.push_back(empty_slot);
+		}
+		entry.slot = free.back(); free.pop_back();
+		ring[entry.slot] = entry.ref; count++; bytes += entry.size;
+	}
+	void resize(Entry& entry, size_t size) { bytes = bytes - entry.size + size; entry.size = size; }
+	auto erase(std::unordered_map<ref_t, Entry>::iterator it) {
+		ring[it->second.slot] = empty_slot; free.push_back(it->second.slot); count--;
+		bytes -= it->second.size;
+		it = map.erase(it);
+		if (free.size() > count + 64) {
+			compact();
+		}
+		return it;
+	}
+private:
+	void compact() {
+		size_t slot = 0, new_hand = 0;
+		for (size_t i = 0; i < ring.size(); ++i) {
+			if (i == hand) { new_hand = slot; }
+			if (ring[i] != empty_slot) { map.at(ring[i]).slot = slot; ring[slot++] = ring[i]; }
+		}
+		hand = hand < ring.size() ? new_hand : slot;
+		ring.resize(slot); free.clear();
+	}
+public:
+	std::vector<ref_t> hot(size_t count, auto filter) const {
+		std::vector<std::pair<uint64, ref_t>> list;
+		for (const auto& [ref, entry] : map) {
+			if (filter(entry)) { list.emplace_back(entry.hits, ref); }
+		}
+		count = std::min(count, list.size());
+		std::partial_sort(list.begin(), list.begin() + count, list.end(), std::greater<>());
+		std::vector<ref_t> ref_list; ref_list.reserve(count);
+		for (size_t i = 0; i < count; ++i) { ref_list.push_back(list[i].second); }
+		return ref_list;
+	}
+public:
+	bool exceeds(size_t size) const {
+		return (option.entry_limit > 0 && count >= option.entry_limit) || (option.byte_limit > 0 && bytes + size > option.byte_limit);
+	}
+public:
+	void reserve(size_t size) {
+		std::vector<ref_t> resident_list;  // resident entries passed over, evicted only if nothing else is left
+		for (size_t step = 0; exceeds(size) && step < 2 * ring.size(); ++step) {
+			if (hand >= ring.size()) {
+				hand = 0;
+			}
+			if (ring[hand] == empty_slot) {
+				hand++;
+				continue;
+			}
+			auto it = map.find(ring[hand]);
+			Entry& entry = it->second;
+			if (entry.count > 0 || dirty.contains(it->first)) {
+				hand++;
+			} else if (entry.referenced) {
+				entry.referenced = false;
+				hand++;
+			} else if (is_resident(entry)) {
+				resident_list.push_back(it->first);
+				hand++;
+			} else {
+				hand++;
+				erase(it);
+				CacheCounters::add(counters.evicted);
+			}
+		}
+		for (size_t i = 0; exceeds(size) && i < resident_list.size(); ++i) {
+			if (auto it = map.find(resident_list[i]); it != map.end()) {
+				erase(it);
+				CacheCounters::add(counters.evicted);
+			}
+		}
+	}
+private:
+	static bool is_resident(const Entry& entry) {
+		if constexpr (requires { entry.resident(); }) {
+			return entry.resident();
+		} else {
+			return false;
+		}
+	}
+};
+
+
 template<class T>
-class BlockCache {
+class BlockCache : private CoherentCache {
 public:
-	BlockCache(BlockManager& manager) : manager(manager) {}
+	BlockCache(BlockManager& manager, const CacheOption& option = {}) : manager(manager), clock(map, dirty, counters, option) {
+		if (option.coherent) {
+			manager.register_cache(*this);
+		}
+	}
+	~BlockCache() {
+		if (warm_up_future.valid()) {
+			warm_up_future.wait();
+		}
+		if (write_back && !dirty.empty()) {
+			try { write_dirty(); } catch (...) { manager.discard_writes(dirty.size()); }
+		}
+		manager.unregister_cache(*this);
+	}
 
 private:
 	BlockManager& manager;
@@ -72,13 +283,35 @@ private:
 		block_ref ref;
 		size_t count;
 		T object;
+		block_stored stored;
+		size_t size = 0;
+		size_t slot = 0;
+		bool referenced = false;
+		uint64 hits = 0;
 	};
 private:
 	std::unordered_map<ref_t, Entry> map;
+	std::unordered_set<ref_t> dirty;
+	CacheCounters counters;
+	CacheClock<Entry> clock;
 private:
 	bool has(ref_t ref) { return map.contains(ref); }
-	T& get(ref_t ref) { auto& entry = map.at(ref); entry.count++; return entry.object; }
-	T& set(const block_ref& ref, T object) { return map.emplace(ref, Entry{ ref, 1, std::move(object) }).first->second.object; }
+	const T* find(const block<T>& ref) { sync(); auto it = map.find(ref); counters.lookup_result(it != map.end()); if (it == map.end()) { return nullptr; } it->second.referenced = true; it->second.hits++; record_read(it->second); return &it->second.object; }
+	T& get(ref_t ref) { auto& entry = map.at(ref); entry.count++; entry.referenced = true; entry.hits++; record_read(entry); return entry.object; }
+	// hits are validated by optimistic transactions like reads of the manager, from the stamp the object was read at
+	void record_read(const Entry& entry) const { manager.record_read(entry.ref, entry.stored.valid ? entry.stored.stamp : uint64(-1)); }
+	void revisit(ref_t ref) { sync(); if (manager.in_transaction()) { record_read(map.at(ref)); } }
+	T& set(const block_ref& ref, T object, block_stored stored = {}) {
+		size_t size = clock.measure(object, stored);
+		clock.reserve(size);
+		if (write_back && can_flush() && clock.exceeds(size)) {
+			flush();
+			clock.reserve(size);
+		}
+		Entry& entry = map.emplace(ref, Entry{ ref, 1, std::move(object), std::move(stored), size }).first->second;
+		clock.insert(entry);
+		return entry.object;
+	}
 
 private:
 	friend class block_view_lazy<T, BlockCache>;
@@ -88,12 +321,17 @@ private:
 
 public:
 	void sweep() {
+		sync();
+		if (write_back && can_flush()) {
+			flush();
+		}
 		if (!dirty.empty()) {
 			throw std::invalid_argument("changes not written");
 		}
 		for (auto it = map.begin(); it != map.end();) {
 			if (it->second.count == 0) {
-				map.erase(it++);
+				it = clock.erase(it);
+				CacheCounters::add(counters.swept);
 			} else {
 				it++;
 			}
@@ -101,28 +339,90 @@ public:
 	}
 
 private:
-	std::unordered_set<ref_t> dirty;
-private:
-	void mark(ref_t ref) { dirty.emplace(ref); }
+	void mark(ref_t ref) {
+		skip_warm_up(ref);
+		if (dirty.empty()) {
+			dirty_begin = std::chrono::steady_clock::now();
+		}
+		if (dirty.emplace(ref).second) {
+			dirty_bytes += map.at(ref).size;
+		}
+	}
+	std::vector<ref_t> commit_list;
 	void try_commit() {
-		for (ref_t ref : dirty) {
+		commit_list.assign(dirty.begin(), dirty.end());
+		std::sort(commit_list.begin(), commit_list.end());
+		for (ref_t ref : commit_list) {
 			Entry& entry = map.at(ref);
-			static_cast<block<T>&>(entry.ref).write(entry.object);
+			auto [written, size] = static_cast<block<T>&>(entry.ref).write_changed(entry.object, entry.stored);
+			counters.flush_result(written, size);
+			clock.resize(entry, clock.measure(entry.object, entry.stored));
 		}
 	}
 	void end_commit() {
 		dirty.clear();
+		dirty_bytes = 0;
+	}
+	void abort_commit() {
+		for (ref_t ref : dirty) {
+			map.at(ref).stored.reset();
+		}
+	}
+	// blocks written elsewhere are dropped if not in use and read again otherwise, while changes of this cache are kept
+	void sync() {
+		if (!has_written()) {
+			return;
+		}
+		auto [ref_list, all] = take_written();
+		if (all) {
+			ref_list.clear();
+			for (auto& [ref, entry] : map) { ref_list.push_back(ref); }
+		}
+		for (ref_t ref : ref_list) {
+			auto it = map.find(ref);
+			if (it == map.end()) {
+				continue;
+			}
+			Entry& entry = it->second;
+			if (entry.stored.valid && entry.stored.stamp == manager.get_write_stamp(ref)) {
+				continue;
+			}
+			if (dirty.contains(ref)) {
+				entry.stored.reset();
+			} else if (entry.count == 0) {
+				clock.erase(it);
+			} else {
+				try {
+					entry.object = static_cast<const block<T>&>(entry.ref).read_stored(entry.stored);
+					clock.resize(entry, clock.measure(entry.object, entry.stored));
+				} catch (const std::exception&) {
+					entry.stored.reset();
+				}
+			}
+		}
 	}
 
 private:
 	const T& lookup_read(const block<T>& ref) {
+		sync();
+		if (!has(ref)) {
+			adopt_warm_up();
+		}
+		counters.lookup_result(has(ref));
 		if (has(ref)) {
 			return get(ref);
 		} else {
-			return set(ref, ref.read());
+			block_stored stored;
+			T object = ref.read_stored(stored);
+			return set(ref, std::move(object), std::move(stored));
 		}
 	}
 	const T& lookup_read(const block<T>& ref, auto init) {
+		sync();
+		if (!has(ref)) {
+			adopt_warm_up();
+		}
+		counters.lookup_result(has(ref));
 		if (has(ref)) {
 			return get(ref);
 		} else {
@@ -130,6 +430,8 @@ private:
 		}
 	}
 	const T& lookup_write(block<T>& ref, auto&&... args) {
+		CacheCounters::add(counters.write);
+		sync();
 		return transaction([&] -> decltype(auto) {
 			if (has(ref)) {
 				auto& object = get(ref);
@@ -144,12 +446,41 @@ private:
 		});
 	}
 	const T& update(ref_t ref, const T& object, auto f) {
+		CacheCounters::add(counters.update);
+		sync();
 		return transaction([&] -> decltype(auto) {
 			f(const_cast<T&>(object));
 			mark(ref);
 			return object;
 		});
 	}
+	template<auto member>
+	void update_field(block<T>& ref, const auto& value) {
+		using Field = std::remove_cvref_t<decltype(std::declval<T&>().*member)>;
+		CacheCounters::add(counters.update);
+		sync();
+		transaction([&] {
+			skip_warm_up(ref);
+			if (has(ref)) {
+				Entry& entry = map.at(ref);
+				entry.object.*member = value;
+				if (!write_back && !dirty.contains(ref) && ref.template write_field<member>(value)) {
+					counters.flush_result(true, flat_layout<Field>::size);
+					if (auto it = map.find(ref); it != map.end()) { it->second.stored.reset(); }  // the write may have invalidated the entry
+					return;
+				}
+			} else {
+				if (ref.template write_field<member>(value)) {
+					counters.flush_result(true, flat_layout<Field>::size);
+					return;
+				}
+				lookup_read(ref);
+				dec_ref(ref);
+				map.at(ref).object.*member = value;
+			}
+			mark(ref);
+		});
+	}
 
 public:
 	block_view_lazy<T, BlockCache<T>> read_lazy(block<T> ref) {
@@ -165,62 +496,358 @@ public:
 		return block_view<T, BlockCache<T>>(manager.allocate(), *this, std::in_place, std::forward<decltype(args)>(args)...);
 	}
 
+private:
+	friend class block_view_future<T, BlockCache>;
+private:
+	void adopt(const block<T>& ref, std::future<T> future) {
+		if (future.valid() && !has(ref)) {
+			set(ref, future.get());
+			dec_ref(ref);
+		}
+	}
+	block_view<T, BlockCache<T>> complete_read(block<T> ref, std::future<T> future) {
+		adopt(ref, std::move(future));
+		return read(std::move(ref));
+	}
+public:
+	block_view_future<T, BlockCache<T>> read_async(block<T> ref) {
+		sync();
+		std::future<T> future = has(ref) ? std::future<T>() : ref.read_async();
+		return block_view_future<T, BlockCache<T>>(std::move(ref), *this, std::move(future));
+	}
+
+public:
+	void prefetch(std::span<const block<T>> ref_list) {
+		sync();
+		std::vector<ref_t> miss_list; std::vector<const block<T>*> miss_ref_list;
+		for (const block<T>& ref : ref_list) {
+			if (!has(ref)) { miss_list.push_back(ref); miss_ref_list.push_back(&ref); }
+		}
+		if (miss_list.empty()) {
+			return;
+		}
+		std::vector<uint64> stamp_list; stamp_list.reserve(miss_list.size());
+		for (ref_t ref : miss_list) { stamp_list.push_back(manager.get_write_stamp(ref)); }
+		std::vector<std::vector<std::byte>> data_list = block_ref::read_batch(manager, miss_list);
+		for (size_t i = 0; i < miss_list.size(); ++i) {
+			if (data_list[i].empty() || has(miss_list[i])) {
+				continue;
+			}
+			block_stored stored;
+			T object = miss_ref_list[i]->read_stored(std::move(data_list[i]), stamp_list[i], stored);
+			set(*miss_ref_list[i], std::move(object), std::move(stored));
+			dec_ref(miss_list[i]);
+			CacheCounters::add(counters.prefetch);
+		}
+	}
+
+private:
+	std::future<std::vector<std::tuple<block<T>, T, block_stored>>> warm_up_future;
+	std::unordered_set<ref_t> warm_up_written;
+private:
+	void skip_warm_up(ref_t ref) {
+		if (warm_up_future.valid()) {
+			warm_up_written.insert(ref);
+		}
+	}
+	void complete_warm_up() {
+		std::vector<std::tuple<block<T>, T, block_stored>> object_list = warm_up_future.get();
+		std::unordered_set<ref_t> written = std::move(warm_up_written); warm_up_written.clear();
+		for (auto& [ref, object, stored] : object_list) {
+			if (!has(ref) && !written.contains(ref) && stored.stamp == manager.get_write_stamp(ref)) {
+				set(ref, std::move(object), std::move(stored));
+				dec_ref(ref);
+			}
+		}
+	}
+	void adopt_warm_up() {
+		if (warm_up_future.valid() && warm_up_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+			complete_warm_up();
+		}
+	}
+public:
+	std::vector<ref_t> hot_list(size_t count) const {
+		return clock.hot(count, [](const Entry&) { return true; });
+	}
+	void save_manifest(const char file[], size_t count) const {
+		CacheManifest::save(file, hot_list(count));
+	}
+	void load_manifest(const char file[]) {
+		warm_up(CacheManifest::load(file));
+	}
+	void warm_up(std::vector<ref_t> ref_list) {
+		wait_warm_up();
+		warm_up_future = manager.run_async([&manager = manager, ref_list = std::move(ref_list)]() {
+			try { return CacheManifest::read<T>(manager, ref_list); } catch (...) { return std::vector<std::tuple<block<T>, T, block_stored>>(); }
+		});
+	}
+	void wait_warm_up() {
+		if (warm_up_future.valid()) {
+			complete_warm_up();
+		}
+	}
+
+public:
+	CacheStats statistics() const { return counters.snapshot(clock.size(), clock.byte_size()); }
+	void reset_statistics() { counters.reset(); }
+
+private:
+	std::optional<WriteBackOption> write_back;
+	std::chrono::steady_clock::time_point dirty_begin;
+	size_t dirty_bytes = 0;
+private:
+	bool should_flush() const {
+		return dirty.size() >= write_back->count_limit || dirty_bytes >= write_back->byte_limit ||
+			std::chrono::steady_clock::now() - dirty_begin >= write_back->time_limit || clock.exceeds(0);
+	}
+	void end_transaction() {
+		if (!write_back) {
+			end_commit();
+		} else if (!dirty.empty() && should_flush() && can_flush()) {
+			flush();
+		}
+	}
+	// the changes are only flushed outside of transactions of the manager, which could roll them back
+	bool can_flush() const { return transaction_level == 0 && !manager.in_transaction(); }
+public:
+	void enable_write_back(const WriteBackOption& option) {
+		option.check();
+		write_back = option;
+	}
+	void disable_write_back() {
+		flush();
+		write_back.reset();
+	}
+	void flush() {
+		if (!can_flush()) {
+			throw std::invalid_argument("cannot flush inside a transaction");
+		}
+		write_dirty();
+	}
+private:
+	// also used by the destructor inside a transaction of the manager, where the changes are kept or rolled back with it
+	void write_dirty() {
+		if (dirty.empty()) {
+			return;
+		}
+		try {
+			manager.transaction([&] { try_commit(); });
+		} catch (...) {
+			abort_commit();
+			throw;
+		}
+		end_commit();
+	}
+
 private:
 	size_t transaction_level = 0;
 public:
 	decltype(auto) transaction(auto f) {
-		if constexpr (std::is_void_v<std::invoke_result_t<decltype(f)>>) {
-			manager.transaction([&] {
-				transaction_level++;
-				f();
-				transaction_level--;
-				if (transaction_level == 0) {
-					try_commit();
-				}
-			});
-			if (transaction_level == 0) {
-				end_commit();
-			}
-		} else {
-			decltype(auto) res = manager.transaction([&] -> decltype(auto) {
-				transaction_level++;
-				decltype(auto) res = f();
-				transaction_level--;
-				if (transaction_level == 0) {
-					try_commit();
-				}
+		if (transaction_level > 0) {
+			return f();
+		}
+		try {
+			if constexpr (std::is_void_v<std::invoke_result_t<decltype(f)>>) {
+				manager.transaction([&] {
+					transaction_level++;
+					f();
+					transaction_level--;
+					if (!write_back) {
+						try_commit();
+					}
+				});
+				end_transaction();
+			} else {
+				decltype(auto) res = manager.transaction([&] -> decltype(auto) {
+					transaction_level++;
+					decltype(auto) res = f();
+					transaction_level--;
+					if (!write_back) {
+						try_commit();
+					}
+					return res;
+				});
+				end_transaction();
 				return res;
-			});
-			if (transaction_level == 0) {
-				end_commit();
 			}
-			return res;
+		} catch (...) {
+			transaction_level = 0;
+			abort_commit();
+			throw;
 		}
 	}
 };
 
 
-class BlockCacheDynamic {
+class BlockCacheDynamic : private CoherentCache {
 public:
-	BlockCacheDynamic(BlockManager& manager) : manager(manager) {}
+	BlockCacheDynamic(BlockManager& manager, const CacheOption& option = {}) : manager(manager), clock(map, dirty, counters, option) {
+		if (option.coherent) {
+			manager.register_cache(*this);
+		}
+	}
+	~BlockCacheDynamic() {
+		if (write_back && !dirty.empty()) {
+			try { write_dirty(); } catch (...) { manager.discard_writes(dirty.size()); }
+		}
+		manager.unregister_cache(*this);
+	}
 
 protected:
 	BlockManager& manager;
 
 private:
-	using write_fn = void(*)(block_ref&, const std::any&);
+	struct Entry;
+	struct SlabBase {
+		bool resident = false;
+		virtual ~SlabBase() {}
+		virtual void erase(size_t index) = 0;
+		virtual std::pair<bool, size_t> write(block_ref& ref, size_t index, block_stored& stored) = 0;
+		virtual size_t measure(const CacheClock<Entry>& clock, size_t index, const block_stored& stored) = 0;
+		virtual void reload(const block_ref& ref, size_t index, block_stored& stored) = 0;
+	};
+	template<class T>
+	struct Slab : SlabBase {
+		constexpr static size_t chunk_size = 64;
+		std::vector<std::unique_ptr<std::optional<T>[]>> chunks;
+		std::vector<size_t> free;
+		size_t count = 0;
+		std::optional<T>& at(size_t index) { return chunks[index / chunk_size][index % chunk_size]; }
+		T& get(size_t index) { return *at(index); }
+		size_t insert(auto&&... args) {
+			size_t index;
+			if (!free.empty()) {
+				index = free.back(); free.pop_back();
+			} else {
+				if (count % chunk_size == 0) {
+					chunks.push_back(std::make_unique<std::optional<T>[]>(chunk_size));
+				}
+				index = count++;
+			}
+			try {
+				at(index).emplace(std::forward<decltype(args)>(args)...);
+			} catch (...) {
+				free.push_back(index);
+				throw;
+			}
+			return index;
+		}
+		void erase(size_t index) override { at(index).reset(); free.push_back(index); }
+		std::pair<bool, size_t> write(block_ref& ref, size_t index, block_stored& stored) override { return static_cast<block<T>&>(ref).write_changed(get(index), stored); }
+		size_t measure(const CacheClock<Entry>& clock, size_t index, const block_stored& stored) override { return clock.measure(get(index), stored, sizeof(std::optional<T>)); }
+		void reload(const block_ref& ref, size_t index, block_stored& stored) override { get(index) = static_cast<const block<T>&>(ref).read_stored(stored); }
+	};
 	struct Entry {
+		constexpr static size_t no_index = -1;
+
 		block_ref ref;
-		size_t count;
-		std::any object;
-		write_fn write;
+		size_t count = 1;
+		SlabBase* slab;
+		size_t index = no_index;  // the slot in the slab, which the entry releases once it is set
+		block_stored stored;
+		size_t size;
+		size_t slot = 0;
+		bool referenced = false;
+		uint64 hits = 0;
+
+		Entry(const block_ref& ref, SlabBase& slab, block_stored stored, size_t size) : ref(ref), slab(&slab), stored(std::move(stored)), size(size) {}
+		Entry(const Entry&) = delete;
+		~Entry() { if (index != no_index) { slab->erase(index); } }
+		bool resident() const { return slab->resident; }
 	};
 private:
+	inline static std::atomic<size_t> type_count = 0;
+	template<class T>
+	static size_t type_index() { static const size_t index = type_count++; return index; }
+private:
+	std::vector<std::unique_ptr<SlabBase>> slabs;
 	std::unordered_map<ref_t, Entry> map;
+	std::unordered_set<ref_t> dirty;
+	CacheCounters counters;
+	CacheClock<Entry> clock;
+private:
+	template<class T>
+	Slab<T>& slab() {
+		size_t index = type_index<T>();
+		if (slabs.size() <= index) {
+			slabs.resize(index + 1);
+		}
+		if (!slabs[index]) {
+			slabs[index] = std::make_unique<Slab<T>>();
+		}
+		return static_cast<Slab<T>&>(*slabs[index]);
+	}
+	template<class T>
+	T* object(Entry& entry) {
+		size_t index = type_index<T>();
+		return index < slabs.size() && entry.slab == slabs[index].get() ? &static_cast<Slab<T>*>(entry.slab)->get(entry.index) : nullptr;
+	}
+	template<class T>
+	T& object_checked(Entry& entry) {
+		if (T* object = this->object<T>(entry)) {
+			return *object;
+		}
+		throw std::invalid_argument("block type mismatch");
+	}
 private:
 	bool has(ref_t ref) { return map.contains(ref); }
-	std::any& get(ref_t ref) { auto& entry = map.at(ref); entry.count++; return entry.object; }
-	std::any& set(const block_ref& ref, std::any object, write_fn write) { return map.emplace(ref, Entry{ ref, 1, std::move(object), write }).first->second.object; }
+	template<class T>
+	T& get(ref_t ref) {
+		Entry& entry = map.at(ref);
+		T& object = object_checked<T>(entry);
+		entry.count++;
+		entry.referenced = true;
+		entry.hits++;
+		record_read(entry);
+		return object;
+	}
+	// hits are validated by optimistic transactions like reads of the manager, from the stamp the object was read at
+	void record_read(const Entry& entry) const { manager.record_read(entry.ref, entry.stored.valid ? entry.stored.stamp : uint64(-1)); }
+	void revisit(ref_t ref) { sync(); if (manager.in_transaction()) { record_read(map.at(ref)); } }
+	template<class T>
+	const T* find(const block<T>& ref) {
+		sync();
+		auto it = map.find(ref);
+		counters.lookup_result(it != map.end());
+		if (it == map.end()) {
+			return nullptr;
+		}
+		it->second.referenced = true;
+		it->second.hits++;
+		record_read(it->second);
+		return object<T>(it->second);
+	}
+	template<class T>
+	T& set_stored(const block_ref& ref, block_stored stored, auto&&... args) {
+		Slab<T>& slab = this->slab<T>();
+		size_t index = slab.insert(std::forward<decltype(args)>(args)...);
+		struct Release {
+			SlabBase* slab;
+			size_t index;
+			~Release() { if (slab) { slab->erase(index); } }
+		} release{ &slab, index };
+		size_t size = slab.measure(clock, index, stored);
+		clock.reserve(size);
+		if (write_back && can_flush() && clock.exceeds(size)) {
+			flush();
+			clock.reserve(size);
+		}
+		// the slot is given to the entry only after the insertion, so that a failed one releases it once
+		auto it = map.try_emplace(ref, ref, slab, std::move(stored), size).first;
+		it->second.index = index;
+		release.slab = nullptr;
+		try {
+			clock.insert(it->second);
+		} catch (...) {
+			map.erase(it);
+			throw;
+		}
+		return slab.get(index);
+	}
+	template<class T>
+	T& set(const block_ref& ref, auto&&... args) {
+		return set_stored<T>(ref, {}, std::forward<decltype(args)>(args)...);
+	}
 
 private:
 	template<class T, class CacheType> friend class block_view_lazy;
@@ -229,12 +856,17 @@ private:
 	void dec_ref(ref_t ref) { map.at(ref).count--; }
 public:
 	void sweep() {
+		sync();
+		if (write_back && can_flush()) {
+			flush();
+		}
 		if (!dirty.empty()) {
 			throw std::invalid_argument("changes not written");
 		}
 		for (auto it = map.begin(); it != map.end();) {
 			if (it->second.count == 0) {
-				map.erase(it++);
+				it = clock.erase(it);
+				CacheCounters::add(counters.swept);
 			} else {
 				it++;
 			}
@@ -242,44 +874,92 @@ public:
 	}
 
 private:
-	std::unordered_set<ref_t> dirty;
-private:
-	void mark(ref_t ref) { dirty.emplace(ref); }
+	void mark(ref_t ref) {
+		skip_warm_up(ref);
+		if (dirty.empty()) {
+			dirty_begin = std::chrono::steady_clock::now();
+		}
+		if (dirty.emplace(ref).second) {
+			dirty_bytes += map.at(ref).size;
+		}
+	}
+	std::vector<ref_t> commit_list;
 	void try_commit() {
-		for (ref_t ref : dirty) {
+		commit_list.assign(dirty.begin(), dirty.end());
+		std::sort(commit_list.begin(), commit_list.end());
+		for (ref_t ref : commit_list) {
 			Entry& entry = map.at(ref);
-			entry.write(entry.ref, entry.object);
+			auto [written, size] = entry.slab->write(entry.ref, entry.index, entry.stored);
+			counters.flush_result(written, size);
+			clock.resize(entry, entry.slab->measure(clock, entry.index, entry.stored));
 		}
 	}
 	void end_commit() {
 		dirty.clear();
+		dirty_bytes = 0;
 	}
-
-private:
-	template<class T>
-	T& get(const block_ref& ref) {
-		return std::any_cast<T&>(get(ref));
+	void abort_commit() {
+		for (ref_t ref : dirty) {
+			map.at(ref).stored.reset();
+		}
 	}
-	template<class T>
-	T& set(const block_ref& ref, auto&&... args) {
-		return std::any_cast<T&>(set(
-			ref,
-			std::make_any<T>(std::forward<decltype(args)>(args)...),
-			[](block_ref& ref, const std::any& object) { static_cast<block<T>&>(ref).write(std::any_cast<const T&>(object)); }
-		));
+	// blocks written elsewhere are dropped if not in use and read again otherwise, while changes of this cache are kept
+	void sync() {
+		if (!has_written()) {
+			return;
+		}
+		auto [ref_list, all] = take_written();
+		if (all) {
+			ref_list.clear();
+			for (auto& [ref, entry] : map) { ref_list.push_back(ref); }
+		}
+		for (ref_t ref : ref_list) {
+			auto it = map.find(ref);
+			if (it == map.end()) {
+				continue;
+			}
+			Entry& entry = it->second;
+			if (entry.stored.valid && entry.stored.stamp == manager.get_write_stamp(ref)) {
+				continue;
+			}
+			if (dirty.contains(ref)) {
+				entry.stored.reset();
+			} else if (entry.count == 0) {
+				clock.erase(it);
+			} else {
+				try {
+					entry.slab->reload(entry.ref, entry.index, entry.stored);
+					clock.resize(entry, entry.slab->measure(clock, entry.index, entry.stored));
+				} catch (const std::exception&) {
+					entry.stored.reset();
+				}
+			}
+		}
 	}
 
 protected:
 	template<class T>
 	const T& lookup_read(const block<T>& ref) {
+		sync();
+		if (!has(ref)) {
+			adopt_warm_up();
+		}
+		counters.lookup_result(has(ref));
 		if (has(ref)) {
 			return get<T>(ref);
 		} else {
-			return set<T>(ref, ref.read());
+			block_stored stored;
+			T object = ref.read_stored(stored);
+			return set_stored<T>(ref, std::move(stored), std::move(object));
 		}
 	}
 	template<class T>
 	const T& lookup_read(const block<T>& ref, auto init) {
+		sync();
+		if (!has(ref)) {
+			adopt_warm_up();
+		}
+		counters.lookup_result(has(ref));
 		if (has(ref)) {
 			return get<T>(ref);
 		} else {
@@ -288,6 +968,8 @@ protected:
 	}
 	template<class T>
 	const T& lookup_write(block<T>& ref, auto&&... args) {
+		CacheCounters::add(counters.write);
+		sync();
 		return transaction([&] -> decltype(auto) {
 			if (has(ref)) {
 				auto& object = get<T>(ref);
@@ -303,12 +985,41 @@ protected:
 	}
 	template<class T>
 	const T& update(ref_t ref, const T& object, auto f) {
+		CacheCounters::add(counters.update);
+		sync();
 		return transaction([&] -> decltype(auto) {
 			f(const_cast<T&>(object));
 			mark(ref);
 			return object;
 		});
 	}
+	template<auto member, class T>
+	void update_field(block<T>& ref, const auto& value) {
+		using Field = std::remove_cvref_t<decltype(std::declval<T&>().*member)>;
+		CacheCounters::add(counters.update);
+		sync();
+		transaction([&] {
+			skip_warm_up(ref);
+			if (has(ref)) {
+				Entry& entry = map.at(ref);
+				object_checked<T>(entry).*member = value;
+				if (!write_back && !dirty.contains(ref) && ref.template write_field<member>(value)) {
+					counters.flush_result(true, flat_layout<Field>::size);
+					if (auto it = map.find(ref); it != map.end()) { it->second.stored.reset(); }  // the write may have invalidated the entry
+					return;
+				}
+			} else {
+				if (ref.template write_field<member>(value)) {
+					counters.flush_result(true, flat_layout<Field>::size);
+					return;
+				}
+				lookup_read(ref);
+				dec_ref(ref);
+				object_checked<T>(map.at(ref)).*member = value;
+			}
+			mark(ref);
+		});
+	}
 
 public:
 	template<class T>
@@ -329,35 +1040,213 @@ public:
 	}
 
 private:
-	size_t transaction_level = 0;
+	template<class T, class CacheType> friend class block_view_future;
+protected:
+	template<class T>
+	void adopt(const block<T>& ref, std::future<T> future) {
+		if (future.valid() && !has(ref)) {
+			set<T>(ref, future.get());
+			dec_ref(ref);
+		}
+	}
+	template<class T>
+	std::future<T> fetch_async(const block<T>& ref) {
+		sync();
+		return has(ref) ? std::future<T>() : ref.read_async();
+	}
+private:
+	template<class T>
+	block_view<T, BlockCacheDynamic> complete_read(block<T> ref, std::future<T> future) {
+		adopt(ref, std::move(future));
+		return read(std::move(ref));
+	}
 public:
-	decltype(auto) transaction(auto f) {
-		if constexpr (std::is_void_v<std::invoke_result_t<decltype(f)>>) {
-			manager.transaction([&] {
-				transaction_level++;
-				f();
-				transaction_level--;
-				if (transaction_level == 0) {
-					try_commit();
-				}
-			});
-			if (transaction_level == 0) {
-				end_commit();
+	template<class T>
+	block_view_future<T, BlockCacheDynamic> read_async(block<T> ref) {
+		std::future<T> future = fetch_async(ref);
+		return block_view_future<T, BlockCacheDynamic>(std::move(ref), *this, std::move(future));
+	}
+
+public:
+	template<class T>
+	void prefetch(std::span<const block<T>> ref_list) {
+		sync();
+		std::vector<ref_t> miss_list; std::vector<const block<T>*> miss_ref_list;
+		for (const block<T>& ref : ref_list) {
+			if (!has(ref)) { miss_list.push_back(ref); miss_ref_list.push_back(&ref); }
+		}
+		if (miss_list.empty()) {
+			return;
+		}
+		std::vector<uint64> stamp_list; stamp_list.reserve(miss_list.size());
+		for (ref_t ref : miss_list) { stamp_list.push_back(manager.get_write_stamp(ref)); }
+		std::vector<std::vector<std::byte>> data_list = block_ref::read_batch(manager, miss_list);
+		for (size_t i = 0; i < miss_list.size(); ++i) {
+			if (data_list[i].empty() || has(miss_list[i])) {
+				continue;
 			}
-		} else {
-			decltype(auto) res = manager.transaction([&] -> decltype(auto) {
-				transaction_level++;
-				decltype(auto) res = f();
-				transaction_level--;
-				if (transaction_level == 0) {
-					try_commit();
+			block_stored stored;
+			T object = miss_ref_list[i]->read_stored(std::move(data_list[i]), stamp_list[i], stored);
+			set_stored<T>(*miss_ref_list[i], std::move(stored), std::move(object));
+			dec_ref(miss_list[i]);
+			CacheCounters::add(counters.prefetch);
+		}
+	}
+
+private:
+	struct WarmUpBase {
+		std::unordered_set<ref_t> written;
+		virtual ~WarmUpBase() {}
+		virtual bool ready() const = 0;
+		virtual void complete(BlockCacheDynamic& cache) = 0;
+	};
+	template<class T>
+	struct WarmUp : WarmUpBase {
+		std::future<std::vector<std::tuple<block<T>, T, block_stored>>> future;
+		WarmUp(std::future<std::vector<std::tuple<block<T>, T, block_stored>>> future) : future(std::move(future)) {}
+		~WarmUp() override { if (future.valid()) { future.wait(); } }
+		bool ready() const override { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+		void complete(BlockCacheDynamic& cache) override {
+			for (auto& [ref, object, stored] : future.get()) {
+				if (!cache.has(ref) && !written.contains(ref) && stored.stamp == cache.manager.get_write_stamp(ref)) {
+					cache.set_stored<T>(ref, std::move(stored), std::move(object));
+					cache.dec_ref(ref);
 				}
+			}
+		}
+	};
+private:
+	std::vector<std::unique_ptr<WarmUpBase>> warm_up_list;
+private:
+	void skip_warm_up(ref_t ref) {
+		for (auto& warm_up : warm_up_list) {
+			warm_up->written.insert(ref);
+		}
+	}
+	void adopt_warm_up(bool wait = false) {
+		for (size_t i = 0; i < warm_up_list.size();) {
+			if (wait || warm_up_list[i]->ready()) {
+				std::unique_ptr<WarmUpBase> warm_up = std::move(warm_up_list[i]);
+				warm_up_list.erase(warm_up_list.begin() + i);
+				warm_up->complete(*this);
+			} else {
+				i++;
+			}
+		}
+	}
+public:
+	template<class T>
+	std::vector<ref_t> hot_list(size_t count) {
+		SlabBase* slab = &this->slab<T>();
+		return clock.hot(count, [=](const Entry& entry) { return entry.slab == slab; });
+	}
+	template<class T>
+	void save_manifest(const char file[], size_t count) {
+		CacheManifest::save(file, hot_list<T>(count));
+	}
+	template<class T>
+	void load_manifest(const char file[]) {
+		warm_up<T>(CacheManifest::load(file));
+	}
+	template<class T>
+	void warm_up(std::vector<ref_t> ref_list) {
+		warm_up_list.push_back(std::make_unique<WarmUp<T>>(manager.run_async([&manager = manager, ref_list = std::move(ref_list)]() {
+			try { return CacheManifest::read<T>(manager, ref_list); } catch (...) { return std::vector<std::tuple<block<T>, T, block_stored>>(); }
+		})));
+	}
+	void wait_warm_up() {
+		adopt_warm_up(true);
+	}
+
+public:
+	CacheStats statistics() const { return counters.snapshot(clock.size(), clock.byte_size()); }
+	void reset_statistics() { counters.reset(); }
+	template<class T>
+	void set_resident(bool resident) { slab<T>().resident = resident; }
+
+private:
+	std::optional<WriteBackOption> write_back;
+	std::chrono::steady_clock::time_point dirty_begin;
+	size_t dirty_bytes = 0;
+private:
+	bool should_flush() const {
+		return dirty.size() >= write_back->count_limit || dirty_bytes >= write_back->byte_limit ||
+			std::chrono::steady_clock::now() - dirty_begin >= write_back->time_limit || clock.exceeds(0);
+	}
+	void end_transaction() {
+		if (!write_back) {
+			end_commit();
+		} else if (!dirty.empty() && should_flush() && can_flush()) {
+			flush();
+		}
+	}
+	// the changes are only flushed outside of transactions of the manager, which could roll them back
+	bool can_flush() const { return transaction_level == 0 && !manager.in_transaction(); }
+public:
+	void enable_write_back(const WriteBackOption& option) {
+		option.check();
+		write_back = option;
+	}
+	void disable_write_back() {
+		flush();
+		write_back.reset();
+	}
+	void flush() {
+		if (!can_flush()) {
+			throw std::invalid_argument("cannot flush inside a transaction");
+		}
+		write_dirty();
+	}
+private:
+	// also used by the destructor inside a transaction of the manager, where the changes are kept or rolled back with it
+	void write_dirty() {
+		if (dirty.empty()) {
+			return;
+		}
+		try {
+			manager.transaction([&] { try_commit(); });
+		} catch (...) {
+			abort_commit();
+			throw;
+		}
+		end_commit();
+	}
+
+private:
+	size_t transaction_level = 0;
+public:
+	decltype(auto) transaction(auto f) {
+		if (transaction_level > 0) {
+			return f();
+		}
+		try {
+			if constexpr (std::is_void_v<std::invoke_result_t<decltype(f)>>) {
+				manager.transaction([&] {
+					transaction_level++;
+					f();
+					transaction_level--;
+					if (!write_back) {
+						try_commit();
+					}
+				});
+				end_transaction();
+			} else {
+				decltype(auto) res = manager.transaction([&] -> decltype(auto) {
+					transaction_level++;
+					decltype(auto) res = f();
+					transaction_level--;
+					if (!write_back) {
+						try_commit();
+					}
+					return res;
+				});
+				end_transaction();
 				return res;
-			});
-			if (transaction_level == 0) {
-				end_commit();
 			}
-			return res;
+		} catch (...) {
+			transaction_level = 0;
+			abort_commit();
+			throw;
 		}
 	}
 
@@ -383,6 +1272,36 @@ public:
 	block_view<T, BlockCacheDynamicAdapter<T>> create(auto&&... args) {
 		return block_view<T, BlockCacheDynamicAdapter<T>>(manager.allocate(), *this, std::in_place, std::forward<decltype(args)>(args)...);
 	}
+private:
+	friend class block_view_future<T, BlockCacheDynamicAdapter<T>>;
+private:
+	block_view<T, BlockCacheDynamicAdapter<T>> complete_read(block<T> ref, std::future<T> future) {
+		adopt(ref, std::move(future));
+		return read(std::move(ref));
+	}
+public:
+	block_view_future<T, BlockCacheDynamicAdapter<T>> read_async(block<T> ref) {
+		std::future<T> future = fetch_async(ref);
+		return block_view_future<T, BlockCacheDynamicAdapter<T>>(std::move(ref), *this, std::move(future));
+	}
+	void prefetch(std::span<const block<T>> ref_list) {
+		BlockCacheDynamic::prefetch<T>(ref_list);
+	}
+	void set_resident(bool resident) {
+		BlockCacheDynamic::set_resident<T>(resident);
+	}
+	std::vector<ref_t> hot_list(size_t count) {
+		return BlockCacheDynamic::hot_list<T>(count);
+	}
+	void save_manifest(const char file[], size_t count) {
+		BlockCacheDynamic::save_manifest<T>(file, count);
+	}
+	void load_manifest(const char file[]) {
+		BlockCacheDynamic::load_manifest<T>(file);
+	}
+	void warm_up(std::vector<ref_t> ref_list) {
+		BlockCacheDynamic::warm_up<T>(std::move(ref_list));
+	}
 };
 
 
@@ -412,12 +1331,31 @@ private:
 	block<T>::write;
 private:
 	mutable std::optional<T> object;
+private:
+	static CacheCounters& counters() { return BlockCacheLocal<T>::counters; }
+	void flush() { counters().flush_result(true, block<T>::write(*object)); }
 public:
-	const T& get() const { if (!object) { object.emplace(block<T>::read()); } return *object; }
-	const T& get(auto init) const { if (!object) { object.emplace(block<T>::read(std::forward<decltype(init)>(init))); } return *object; }
-	const T& set(auto&&... args) { object.emplace(std::forward<decltype(args)>(args)...); block<T>::write(*object); return *object; }
-	const T& update(auto f) { return block_ref::get_manager().transaction([&] -> decltype(auto) { const T& val = get(); f(const_cast<T&>(*object)); block<T>::write(*object); return val; }); }
-	const T& update(auto f, auto init) { return block_ref::get_manager().transaction([&] -> decltype(auto) { const T& val = get(std::forward<decltype(init)>(init)); f(const_cast<T&>(*object)); block<T>::write(*object); return val; }); }
+	const T& get() const { counters().lookup_result(object.has_value()); if (!object) { object.emplace(block<T>::read()); } return *object; }
+	const T& get(auto init) const { counters().lookup_result(object.has_value()); if (!object) { object.emplace(block<T>::read(std::forward<decltype(init)>(init))); } return *object; }
+	template<auto member> auto get_field() const { counters().lookup_result(object.has_value()); if (object) { return (*object).*member; } else { return block<T>::template read_field<member>(); } }
+	decltype(auto) inspect(auto f) const { counters().lookup_result(object.has_value()); if (object) { return f(*object); } else { return block_view_bytes<T>(*this).inspect(f); } }
+	const T& set(auto&&... args) { CacheCounters::add(counters().write); object.emplace(std::forward<decltype(args)>(args)...); flush(); return *object; }
+	const T& update(auto f) { CacheCounters::add(counters().update); return block_ref::get_manager().transaction([&] -> decltype(auto) { const T& val = get(); f(const_cast<T&>(*object)); flush(); return val; }); }
+	const T& update(auto f, auto init) { CacheCounters::add(counters().update); return block_ref::get_manager().transaction([&] -> decltype(auto) { const T& val = get(std::forward<decltype(init)>(init)); f(const_cast<T&>(*object)); flush(); return val; }); }
+	template<auto member> void set_field(const auto& value) {
+		using Field = std::remove_cvref_t<decltype(std::declval<T&>().*member)>;
+		CacheCounters::add(counters().update);
+		block_ref::get_manager().transaction([&] {
+			if (object) {
+				(*object).*member = value;
+			}
+			if (block<T>::template write_field<member>(value)) {
+				counters().flush_result(true, flat_layout<Field>::size);
+			} else {
+				get(); (*object).*member = value; flush();
+			}
+		});
+	}
 };
 
 template<class T>
@@ -453,6 +1391,14 @@ private:
 public:
 	static void sweep() {}
 
+private:
+	friend class block_view_lazy<T, BlockCacheLocal<T>>;
+private:
+	inline static CacheCounters counters;  // shared by the views of T of all managers
+public:
+	static CacheStats statistics() { return counters.snapshot(); }
+	static void reset_statistics() { counters.reset(); }
+
 public:
 	static block_view_local_lazy<T> read_lazy(block<T> ref) {
 		return block_view_local_lazy<T>(std::move(ref));
@@ -467,6 +1413,21 @@ public:
 		return block_view_local<T>(manager.allocate(), std::in_place, std::forward<decltype(args)>(args)...);
 	}
 
+private:
+	friend class block_view_future<T, BlockCacheLocal<T>>;
+private:
+	static block_view_local<T> complete_read(block<T> ref, std::future<T> future) {
+		block_view_local_lazy<T> view(std::move(ref));
+		view.object.emplace(future.get());
+		return block_view_local<T>(std::move(view));
+	}
+public:
+	block_view_future<T, BlockCacheLocal<T>> read_async(block<T> ref) {
+		std::future<T> future = ref.read_async();
+		return block_view_future<T, BlockCacheLocal<T>>(std::move(ref), *this, std::move(future));
+	}
+	static void prefetch(std::span<const block<T>> ref_list) {}
+
 public:
 	decltype(auto) transaction(auto f) { return manager.transaction(std::forward<decltype(f)>(f)); }
 };
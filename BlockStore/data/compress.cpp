@@ -0,0 +1,179 @@
+#include "compress.h"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace BlockStore {
+
+namespace {
+
+constexpr size_t min_match = 4;
+constexpr size_t max_offset = 0xFFFF;
+constexpr size_t hash_bits = 12;
+
+inline uint32_t load32(const std::byte* data) {
+	uint32_t value;
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+inline size_t hash32(uint32_t value) {
+	return (value * 2654435761u) >> (32 - hash_bits);
+}
+
+inline void put_length(std::vector<std::byte>& output, size_t length) {
+	for (; length >= 0xFF; length -= 0xFF) {
+		output.push_back(std::byte(0xFF));
+	}
+	output.push_back(static_cast<std::byte>(length));
+}
+
+inline void put_varint(std::vector<std::byte>& output, uint64 value) {
+	for (; value >= 0x80; value >>= 7) {
+		output.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+	}
+	output.push_back(static_cast<std::byte>(value));
+}
+
+inline void put_sequence(std::vector<std::byte>& output, const std::byte* literal, size_t literal_length, size_t offset, size_t match_length) {
+	size_t match_code = match_length == 0 ? 0 : match_length - min_match;
+	output.push_back(static_cast<std::byte>((std::min<size_t>(literal_length, 0xF) << 4) | std::min<size_t>(match_code, 0xF)));
+	if (literal_length >= 0xF) {
+		put_length(output, literal_length - 0xF);
+	}
+	output.insert(output.end(), literal, literal + literal_length);
+	if (match_length > 0) {
+		output.push_back(static_cast<std::byte>(offset & 0xFF));
+		output.push_back(static_cast<std::byte>(offset >> 8));
+		if (match_code >= 0xF) {
+			put_length(output, match_code - 0xF);
+		}
+	}
+}
+
+struct Reader {
+	const std::byte* data;
+	const std::byte* end;
+
+	size_t get() {
+		if (data == end) {
+			throw std::runtime_error("decompression error");
+		}
+		return static_cast<size_t>(*data++);
+	}
+	size_t get_length(size_t length) {
+		if (length == 0xF) {
+			size_t byte;
+			do {
+				byte = get();
+				length += byte;
+			} while (byte == 0xFF);
+		}
+		return length;
+	}
+	uint64 get_varint() {
+		uint64 value = 0;
+		for (unsigned shift = 0; shift < 64; shift += 7) {
+			uint64 byte = get();
+			value |= (byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				return value;
+			}
+		}
+		throw std::runtime_error("decompression error");
+	}
+};
+
+} // namespace
+
+
+void lz_compress(const std::byte* data, size_t size, std::vector<std::byte>& output) {
+	output.reserve(output.size() + size + size / 255 + 16);
+	put_varint(output, size);
+	std::array<uint32_t, size_t(1) << hash_bits> table = {};
+	size_t anchor = 0;
+	for (size_t index = 0; index + min_match <= size;) {
+		uint32_t value = load32(data + index);
+		uint32_t& entry = table[hash32(value)];
+		size_t candidate = entry; entry = static_cast<uint32_t>(index + 1);
+		if (candidate == 0 || index + 1 - candidate > max_offset || load32(data + candidate - 1) != value) {
+			index++;
+			continue;
+		}
+		candidate--;
+		size_t length = min_match;
+		while (index + length < size && data[candidate + length] == data[index + length]) {
+			length++;
+		}
+		put_sequence(output, data + anchor, index - anchor, index - candidate, length);
+		index += length;
+		anchor = index;
+	}
+	put_sequence(output, data + anchor, size - anchor, 0, 0);
+}
+
+void lz_decompress(const std::byte* data, size_t size, std::vector<std::byte>& output) {
+	Reader reader{ data, data + size };
+	uint64 output_size = reader.get_varint();
+	if (output_size > size * 255 + 16) {
+		throw std::runtime_error("decompression error");
+	}
+	size_t begin = output.size();
+	output.reserve(begin + output_size);
+	output_size += begin;
+	while (reader.data != reader.end) {
+		size_t token = reader.get();
+		size_t literal_length = reader.get_length(token >> 4);
+		if (static_cast<size_t>(reader.end - reader.data) < literal_length || output_size - output.size() < literal_length) {
+			throw std::runtime_error("decompression error");
+		}
+		output.insert(output.end(), reader.data, reader.data + literal_length);
+		reader.data += literal_length;
+		if (reader.data == reader.end) {
+			break;
+		}
+		size_t offset = reader.get(); offset |= reader.get() << 8;
+		size_t match_length = reader.get_length(token & 0xF) + min_match;
+		if (offset == 0 || offset > output.size() - begin || output_size - output.size() < match_length) {
+			throw std::runtime_error("decompression error");
+		}
+		for (size_t from = output.size() - offset, i = 0; i < match_length; ++i) {
+			output.push_back(output[from + i]);
+		}
+	}
+	if (output.size() != output_size) {
+		throw std::runtime_error("decompression error");
+	}
+}
+
+
+bool block_compress(const std::vector<std::byte>& data, block_compression compression, std::vector<std::byte>& output) {
+	if (compression == block_compression::none || data.size() < block_compression_threshold + 1) {
+		return false;
+	}
+	output.assign(1, data.front() | static_cast<std::byte>(static_cast<unsigned char>(compression) << 4));
+	lz_compress(data.data() + 1, data.size() - 1, output);
+	return output.size() < data.size();
+}
+
+std::vector<std::byte> block_decompress(std::vector<std::byte> data) {
+	if (data.empty()) {
+		return data;
+	}
+	switch (static_cast<block_compression>(static_cast<unsigned char>(data.front()) >> 4)) {
+	case block_compression::none:
+		return data;
+	case block_compression::lz: {
+		std::vector<std::byte> output = { data.front() & std::byte(0x0F) };
+		lz_decompress(data.data() + 1, data.size() - 1, output);
+		return output;
+	}
+	default:
+		throw std::runtime_error("unsupported block compression");
+	}
+}
+
+
+} // namespace BlockStore
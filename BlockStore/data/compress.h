@@ -0,0 +1,22 @@
+#pragma once
+
+#include "../core/type.h"
+
+#include <vector>
+#include <cstddef>
+
+
+namespace BlockStore {
+
+constexpr size_t block_compression_threshold = 64; // byte
+
+
+void lz_compress(const std::byte* data, size_t size, std::vector<std::byte>& output);
+void lz_decompress(const std::byte* data, size_t size, std::vector<std::byte>& output);
+
+
+bool block_compress(const std::vector<std::byte>& data, block_compression compression, std::vector<std::byte>& output);  // false if not smaller
+std::vector<std::byte> block_decompress(std::vector<std::byte> data);
+
+
+} // namespace BlockStore
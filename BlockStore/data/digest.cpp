@@ -0,0 +1,64 @@
+#include "digest.h"
+
+#include <random>
+#include <bit>
+
+
+namespace BlockStore {
+
+namespace {
+
+
+const std::array<uint64, 2>& digest_key() {
+	static const std::array<uint64, 2> key = [] {
+		std::random_device device;
+		auto word = [&] { return (static_cast<uint64>(device()) << 32) | device(); };
+		return std::array<uint64, 2>{ word(), word() };
+	}();
+	return key;
+}
+
+struct SipState {
+	uint64 v0, v1, v2, v3;
+
+	void round() {
+		v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; v0 = std::rotl(v0, 32);
+		v2 += v3; v3 = std::rotl(v3, 16); v3 ^= v2;
+		v0 += v3; v3 = std::rotl(v3, 21); v3 ^= v0;
+		v2 += v1; v1 = std::rotl(v1, 17); v1 ^= v2; v2 = std::rotl(v2, 32);
+	}
+	void compress(uint64 word) {
+		v3 ^= word; round(); round(); v0 ^= word;
+	}
+	uint64 finalize(uint64 flag) {
+		v2 ^= flag; round(); round(); round(); round();
+		return v0 ^ v1 ^ v2 ^ v3;
+	}
+};
+
+uint64 load(const std::byte* data, size_t size) {
+	uint64 word = 0;
+	for (size_t i = 0; i < size; ++i) { word |= static_cast<uint64>(data[i]) << (8 * i); }
+	return word;
+}
+
+
+} // namespace
+
+
+block_digest digest(const std::vector<std::byte>& data) {
+	auto [k0, k1] = digest_key();
+	SipState state{ 0x736f6d6570736575ull ^ k0, 0x646f72616e646f6dull ^ k1 ^ 0xee, 0x6c7967656e657261ull ^ k0, 0x7465646279746573ull ^ k1 };
+	size_t size = data.size(), tail = size % 8;
+	for (size_t i = 0; i < size - tail; i += 8) {
+		state.compress(load(data.data() + i, 8));
+	}
+	state.compress((static_cast<uint64>(size) << 56) | load(data.data() + size - tail, tail));
+	uint64 first = state.finalize(0xee);
+	state.v1 ^= 0xdd;
+	uint64 second = state.finalize(0);
+	return { first, second };
+}
+
+
+} // namespace BlockStore
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "../core/type.h"
+
+#include <vector>
+#include <array>
+#include <cstddef>
+
+
+namespace BlockStore {
+
+
+using block_digest = std::array<uint64, 2>;
+
+
+// SipHash-2-4 with 128-bit output, keyed at random once per process so that colliding data can't be prepared in advance
+block_digest digest(const std::vector<std::byte>& data);
+
+
+} // namespace BlockStore
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "../core/ref.h"
+
+#include "CppSerialize/layout_traits.h"
+
+#include <array>
+#include <tuple>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace BlockStore {
+
+using CppSerialize::layout_traits;
+using CppSerialize::layout_trivial;
+
+template<class T>
+class block;
+
+
+template<class Member>
+struct member_pointer_traits;
+
+template<class T, class Field>
+struct member_pointer_traits<Field T::*> {
+	using field_type = Field;
+};
+
+
+template<class T>
+struct flat_layout {
+	constexpr static bool is_static = false;
+};
+
+template<class T> requires layout_trivial<T>
+struct flat_layout<T> {
+	constexpr static bool is_static = true;
+	constexpr static size_t size = sizeof(T);
+	constexpr static size_t ref_size = 0;
+};
+
+template<>
+struct flat_layout<block_ref> {
+	constexpr static bool is_static = true;
+	constexpr static size_t size = sizeof(ref_t);
+	constexpr static size_t ref_size = 1;
+};
+
+template<class T>
+struct flat_layout<block<T>> : flat_layout<block_ref> {};
+
+template<class... Ts>
+struct flat_layout_sequence {
+	constexpr static bool is_static = (flat_layout<Ts>::is_static && ...);
+	constexpr static size_t size = is_static ? (flat_layout<Ts>::size + ... + 0) : 0;
+	constexpr static size_t ref_size = is_static ? (flat_layout<Ts>::ref_size + ... + 0) : 0;
+};
+
+template<class T1, class T2> requires (!layout_trivial<std::pair<T1, T2>>)
+struct flat_layout<std::pair<T1, T2>> : flat_layout_sequence<T1, T2> {};
+
+template<class... Ts> requires (!layout_trivial<std::tuple<Ts...>>)
+struct flat_layout<std::tuple<Ts...>> : flat_layout_sequence<Ts...> {};
+
+template<class T> requires requires { typename T::layout_members; }
+struct flat_layout<T> : T::layout_members::sequence {};
+
+
+template<class T>
+constexpr size_t flat_static_size() {
+	if constexpr (flat_layout<T>::is_static) {
+		return flat_layout<T>::size;
+	} else {
+		return 0;
+	}
+}
+
+
+template<class T>
+constexpr size_t flat_static_ref_size() {
+	if constexpr (flat_layout<T>::is_static) {
+		return flat_layout<T>::ref_size;
+	} else {
+		return 0;
+	}
+}
+
+
+template<auto... members>
+struct member_layout {
+	using sequence = flat_layout_sequence<typename member_pointer_traits<decltype(members)>::field_type...>;
+
+	constexpr static auto declare() { return CppSerialize::declare(members...); }
+
+	constexpr static void read(auto f, const auto& object) { (f(object.*members), ...); }
+	constexpr static void write(auto f, auto& object) { (f(object.*members), ...); }
+
+	template<auto member>
+	constexpr static std::pair<size_t, size_t> location() {
+		size_t offset = 0; size_t ref_offset = 0; bool found = false; bool is_static = true;
+		([&] {
+			using Field = typename member_pointer_traits<decltype(members)>::field_type;
+			if constexpr (std::is_same_v<decltype(members), decltype(member)>) {
+				found = found || members == member;
+			}
+			if (!found) {
+				is_static = is_static && flat_layout<Field>::is_static;
+				offset += flat_static_size<Field>();
+				ref_offset += flat_static_ref_size<Field>();
+			}
+		}(), ...);
+		if (!found || !is_static) {
+			throw std::invalid_argument("field offset not static");
+		}
+		return { offset, ref_offset };
+	}
+	template<auto member>
+	constexpr static size_t offset() { return location<member>().first; }
+	template<auto member>
+	constexpr static size_t ref_offset() { return location<member>().second; }
+};
+
+
+template<class T>
+concept layout_static = flat_layout<T>::is_static && !layout_trivial<T> && !std::is_base_of_v<block_ref, T>;
+
+
+struct static_codec : protected block_ref_deserialize {
+	static void encode(BlockManager&, const layout_trivial auto& object, std::byte*& data, ref_t*&) {
+		std::memcpy(data, &object, sizeof(object));
+		data += sizeof(object);
+	}
+	static void encode(BlockManager& manager, const block_ref& object, std::byte*& data, ref_t*& ref_list) {
+		if (&manager != &object.get_manager()) {
+			throw std::invalid_argument("block manager mismatch");
+		}
+		ref_t ref = object;
+		encode(manager, ref, data, ref_list);
+		*ref_list++ = ref;
+	}
+	template<class T1, class T2>
+	static void encode(BlockManager& manager, const std::pair<T1, T2>& object, std::byte*& data, ref_t*& ref_list) requires (!layout_trivial<std::pair<T1, T2>>) {
+		encode(manager, object.first, data, ref_list);
+		encode(manager, object.second, data, ref_list);
+	}
+	template<class... Ts>
+	static void encode(BlockManager& manager, const std::tuple<Ts...>& object, std::byte*& data, ref_t*& ref_list) requires (!layout_trivial<std::tuple<Ts...>>) {
+		std::apply([&](const auto&... items) { (encode(manager, items, data, ref_list), ...); }, object);
+	}
+	template<class T> requires requires { typename T::layout_members; }
+	static void encode(BlockManager& manager, const T& object, std::byte*& data, ref_t*& ref_list) {
+		T::layout_members::read([&](const auto& item) { encode(manager, item, data, ref_list); }, object);
+	}
+
+	static void decode(BlockManager&, layout_trivial auto& object, const std::byte*& data) {
+		std::memcpy(&object, data, sizeof(object));
+		data += sizeof(object);
+	}
+	static void decode(BlockManager& manager, block_ref& object, const std::byte*& data) {
+		ref_t ref;
+		decode(manager, ref, data);
+		object = construct(manager, ref);
+	}
+	template<class T1, class T2>
+	static void decode(BlockManager& manager, std::pair<T1, T2>& object, const std::byte*& data) requires (!layout_trivial<std::pair<T1, T2>>) {
+		decode(manager, object.first, data);
+		decode(manager, object.second, data);
+	}
+	template<class... Ts>
+	static void decode(BlockManager& manager, std::tuple<Ts...>& object, const std::byte*& data) requires (!layout_trivial<std::tuple<Ts...>>) {
+		std::apply([&](auto&... items) { (decode(manager, items, data), ...); }, object);
+	}
+	template<class T> requires requires { typename T::layout_members; }
+	static void decode(BlockManager& manager, T& object, const std::byte*& data) {
+		T::layout_members::write([&](auto& item) { decode(manager, item, data); }, object);
+	}
+};
+
+
+} // namespace BlockStore
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "block.h"
+
+#include <fstream>
+#include <tuple>
+
+
+namespace BlockStore {
+
+
+class CacheManifest : private block_ref_deserialize {
+private:
+	constexpr static uint64 manifest_version = 2026'10'19'01;
+	constexpr static size_t read_batch_size = 256;
+
+	// little-endian words: version, count, the references, and a checksum of the preceding words
+private:
+	static void put(std::vector<std::byte>& data, uint64 value) {
+		for (size_t i = 0; i < sizeof(uint64); ++i) { data.push_back(static_cast<std::byte>(value >> (8 * i))); }
+	}
+	static uint64 get(const std::byte* data) {
+		uint64 value = 0;
+		for (size_t i = 0; i < sizeof(uint64); ++i) { value |= static_cast<uint64>(data[i]) << (8 * i); }
+		return value;
+	}
+	static uint64 checksum(const std::vector<std::byte>& data, size_t size) {
+		uint64 hash = 0xcbf29ce484222325ull;
+		for (size_t i = 0; i < size; ++i) { hash = (hash ^ static_cast<uint64>(data[i])) * 0x100000001b3ull; }
+		return hash;
+	}
+
+public:
+	static void save(const char file[], const std::vector<ref_t>& ref_list) {
+		std::vector<std::byte> data; data.reserve((ref_list.size() + 3) * sizeof(uint64));
+		put(data, manifest_version);
+		put(data, ref_list.size());
+		for (ref_t ref : ref_list) { put(data, ref); }
+		put(data, checksum(data, data.size()));
+		std::ofstream stream(file, std::ios::binary | std::ios::trunc);
+		stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+		if (!stream.flush()) {
+			throw std::runtime_error("manifest write error");
+		}
+	}
+	// a missing, truncated or corrupt file, or one of another version, loads nothing
+	static std::vector<ref_t> load(const char file[]) {
+		std::ifstream stream(file, std::ios::binary | std::ios::ate);
+		if (!stream) {
+			return {};
+		}
+		std::vector<std::byte> data(static_cast<size_t>(stream.tellg()));
+		if (!stream.seekg(0) || !stream.read(reinterpret_cast<char*>(data.data()), data.size())) {
+			return {};
+		}
+		if (data.size() < 3 * sizeof(uint64) || data.size() % sizeof(uint64) != 0) {
+			return {};
+		}
+		size_t size = data.size() / sizeof(uint64) - 3;
+		if (get(data.data()) != manifest_version || get(data.data() + sizeof(uint64)) != size ||
+			get(data.data() + data.size() - sizeof(uint64)) != checksum(data, data.size() - sizeof(uint64))) {
+			return {};
+		}
+		std::vector<ref_t> ref_list; ref_list.reserve(size);
+		for (size_t i = 0; i < size; ++i) { ref_list.push_back(get(data.data() + (i + 2) * sizeof(uint64))); }
+		return ref_list;
+	}
+
+public:
+	template<class T>
+	static std::vector<std::tuple<block<T>, T, block_stored>> read(BlockManager& manager, const std::vector<ref_t>& ref_list) {
+		std::vector<std::tuple<block<T>, T, block_stored>> object_list;
+		for (size_t begin = 0; begin < ref_list.size(); begin += read_batch_size) {
+			std::vector<ref_t> batch(ref_list.begin() + begin, ref_list.begin() + std::min(begin + read_batch_size, ref_list.size()));
+			std::vector<block<T>> block_list; block_list.reserve(batch.size());
+			for (ref_t ref : batch) {
+				block_list.emplace_back(construct(manager, ref));
+			}
+			std::vector<uint64> stamp_list; stamp_list.reserve(batch.size());
+			for (ref_t ref : batch) { stamp_list.push_back(manager.get_write_stamp(ref)); }
+			std::vector<std::vector<std::byte>> data_list = block_ref::read_batch(manager, batch);
+			for (size_t i = 0; i < batch.size(); ++i) {
+				if (data_list[i].empty()) {
+					continue;
+				}
+				try {
+					block_stored stored;
+					T object = block_list[i].read_stored(std::move(data_list[i]), stamp_list[i], stored);
+					object_list.emplace_back(std::move(block_list[i]), std::move(object), std::move(stored));
+				} catch (const std::runtime_error&) {}
+			}
+		}
+		return object_list;
+	}
+};
+
+
+} // namespace BlockStore
@@ -1,24 +1,66 @@
 #pragma once
 
-#include "../core/ref.h"
-
-#include "CppSerialize/layout_traits.h"
+#include "layout.h"
+#include "compress.h"
+#include "../core/manager.h"
 
 #include <array>
+#include <vector>
+#include <string>
 #include <bit>
+#include <cstring>
 #include <stdexcept>
 
 
 namespace BlockStore {
 
-using CppSerialize::layout_traits;
-using CppSerialize::layout_trivial;
+template<class T>
+concept layout_contiguous = layout_trivial<T> && !std::is_same_v<T, bool>;
+
+
+template<class T>
+class buffer_pool {
+private:
+	static constexpr size_t pool_size_limit = 16;
+	inline static thread_local std::vector<std::vector<T>> pool;
+public:
+	static std::vector<T> acquire(size_t size) {
+		std::vector<T> buffer;
+		if (!pool.empty()) {
+			buffer = std::move(pool.back()); pool.pop_back();
+		}
+		buffer.reserve(size);
+		return buffer;
+	}
+	static void release(std::vector<T> buffer) {
+		if (pool.size() < pool_size_limit && buffer.capacity() > 0) {
+			buffer.clear();
+			pool.push_back(std::move(buffer));
+		}
+	}
+};
+
+
+inline size_t varint_size(uint64 value) {
+	size_t size = 1;
+	for (; value >= 0x80; value >>= 7) {
+		size++;
+	}
+	return size;
+}
+
+inline uint64 zigzag_encode(uint64 value) { return (value << 1) ^ (0 - (value >> 63)); }
+inline uint64 zigzag_decode(uint64 value) { return (value >> 1) ^ (0 - (value & 1)); }
+
+template<class T>
+concept ref_type = std::is_base_of_v<block_ref, T>;
 
 
 struct SizeContext {
 public:
-	SizeContext() {}
+	SizeContext(block_format format = block_format::fixed) : format(format) {}
 private:
+	block_format format;
 	size_t size = 0;
 	size_t ref_size = 0;
 public:
@@ -31,10 +73,63 @@ public:
 		return *this;
 	}
 	SizeContext& access(const block_ref& object) {
-		access(static_cast<ref_t>(object));
+		if (format == block_format::compact) {
+			size += varint_size(object);
+		} else {
+			access(static_cast<ref_t>(object));
+		}
 		ref_size++;
 		return *this;
 	}
+	template<class T>
+	SizeContext& access(const std::vector<T>& object) {
+		access_length(object.size());
+		for (const T& item : object) {
+			access(item);
+		}
+		return *this;
+	}
+	template<layout_contiguous T>
+	SizeContext& access(const std::vector<T>& object) {
+		access_length(object.size());
+		size += object.size() * sizeof(T);
+		return *this;
+	}
+	SizeContext& access(const std::string& object) {
+		access_length(object.size());
+		size += object.size();
+		return *this;
+	}
+	template<ref_type T>
+	SizeContext& access(const std::vector<T>& object) {
+		access_length(object.size());
+		if (format == block_format::compact) {
+			ref_t prev = 0;
+			for (const block_ref& item : object) {
+				size += varint_size(zigzag_encode(item - prev));
+				prev = item;
+			}
+		} else {
+			size += object.size() * sizeof(ref_t);
+		}
+		ref_size += object.size();
+		return *this;
+	}
+	template<layout_static T>
+	SizeContext& access(const T& object) {
+		if (format == block_format::compact) {
+			layout_traits<T>::read([&](const auto& item) { access(item); }, object);
+		} else {
+			size += flat_layout<T>::size;
+			ref_size += flat_layout<T>::ref_size;
+		}
+		return *this;
+	}
+private:
+	void access_length(size_t length) {
+		size += format == block_format::compact ? varint_size(length) : sizeof(uint64);
+	}
+public:
 	SizeContext& access(const auto& object) {
 		layout_traits<std::remove_cvref_t<decltype(object)>>::read([&](const auto& item) { access(item); }, object);
 		return *this;
@@ -44,15 +139,34 @@ public:
 
 struct SerializeContext {
 public:
-	SerializeContext(BlockManager& manager) : manager(manager) {}
+	SerializeContext(BlockManager& manager) : SerializeContext(manager, 0, 0) {}
+	SerializeContext(BlockManager& manager, size_t size, size_t ref_size) : SerializeContext(manager, manager.get_block_format(), size, ref_size) {}
+	SerializeContext(BlockManager& manager, block_format format, size_t size, size_t ref_size) : manager(manager), format(format), data(buffer_pool<std::byte>::acquire(size + 1)), ref_list(buffer_pool<ref_t>::acquire(ref_size)) {
+		data.push_back(static_cast<std::byte>(format));
+	}
+	~SerializeContext() { Recycle(std::move(data), std::move(ref_list)); }
 private:
 	BlockManager& manager;
+	block_format format;
 	std::vector<std::byte> data;
 	std::vector<ref_t> ref_list;
 public:
 	std::pair<std::vector<std::byte>, std::vector<ref_t>> Get() {
+		if (data.size() == 1) {
+			data.clear();
+		} else if (block_compression compression = manager.get_block_compression(); compression != block_compression::none) {
+			std::vector<std::byte> compressed = buffer_pool<std::byte>::acquire(data.size());
+			if (block_compress(data, compression, compressed)) {
+				std::swap(data, compressed);
+			}
+			buffer_pool<std::byte>::release(std::move(compressed));
+		}
 		return std::make_pair(std::move(data), std::move(ref_list));
 	}
+	static void Recycle(std::vector<std::byte> data, std::vector<ref_t> ref_list) {
+		buffer_pool<std::byte>::release(std::move(data));
+		buffer_pool<ref_t>::release(std::move(ref_list));
+	}
 public:
 	SerializeContext& access(const layout_trivial auto& object) {
 		auto bytes = std::bit_cast<std::array<std::byte, sizeof(object)>>(object);
@@ -63,10 +177,89 @@ public:
 		if (&manager != &object.get_manager()) {
 			throw std::invalid_argument("block manager mismatch");
 		}
-		access(static_cast<ref_t>(object));
+		if (format == block_format::compact) {
+			access_varint(object);
+		} else {
+			access(static_cast<ref_t>(object));
+		}
 		ref_list.push_back(object);
 		return *this;
 	}
+	template<class T>
+	SerializeContext& access(const std::vector<T>& object) {
+		access_length(object.size());
+		for (const T& item : object) {
+			access(item);
+		}
+		return *this;
+	}
+	template<layout_contiguous T>
+	SerializeContext& access(const std::vector<T>& object) {
+		access_span(object.data(), object.size());
+		return *this;
+	}
+	SerializeContext& access(const std::string& object) {
+		access_span(object.data(), object.size());
+		return *this;
+	}
+	template<ref_type T>
+	SerializeContext& access(const std::vector<T>& object) {
+		access_length(object.size());
+		if (format == block_format::compact) {
+			ref_t prev = 0;
+			for (const block_ref& item : object) {
+				if (&manager != &item.get_manager()) {
+					throw std::invalid_argument("block manager mismatch");
+				}
+				access_varint(zigzag_encode(item - prev));
+				ref_list.push_back(item);
+				prev = item;
+			}
+		} else {
+			for (const block_ref& item : object) {
+				access(item);
+			}
+		}
+		return *this;
+	}
+	template<layout_static T>
+	SerializeContext& access(const T& object) {
+		if (format == block_format::compact) {
+			layout_traits<T>::read([&](const auto& item) { access(item); }, object);
+			return *this;
+		}
+		size_t offset = data.size(), ref_offset = ref_list.size();
+		data.resize(offset + flat_layout<T>::size);
+		ref_list.resize(ref_offset + flat_layout<T>::ref_size);
+		std::byte* data_begin = data.data() + offset; ref_t* ref_begin = ref_list.data() + ref_offset;
+		static_codec::encode(manager, object, data_begin, ref_begin);
+		return *this;
+	}
+private:
+	void access_varint(uint64 value) {
+		for (; value >= 0x80; value >>= 7) {
+			data.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+		}
+		data.push_back(static_cast<std::byte>(value));
+	}
+	// lengths of vectors and strings, the only integers stored as varints in the compact format
+	void access_length(size_t length) {
+		if (format == block_format::compact) {
+			access_varint(length);
+		} else {
+			access(static_cast<uint64>(length));
+		}
+	}
+	template<class T>
+	void access_span(const T* object, size_t size) {
+		access_length(size);
+		if (size > 0) {
+			size_t offset = data.size();
+			data.resize(offset + size * sizeof(T));
+			std::memcpy(data.data() + offset, object, size * sizeof(T));
+		}
+	}
+public:
 	SerializeContext& access(const auto& object) {
 		layout_traits<std::remove_cvref_t<decltype(object)>>::read([&](const auto& item) { access(item); }, object);
 		return *this;
@@ -76,11 +269,21 @@ public:
 
 struct DeserializeContext : protected block_ref_deserialize {
 public:
-	DeserializeContext(BlockManager& manager, std::vector<std::byte> data) : manager(manager), data(std::move(data)), index(this->data.begin()) {}
+	DeserializeContext(BlockManager& manager, std::vector<std::byte> data) : manager(manager), data(block_decompress(std::move(data))), index(this->data.begin()), format(block_format::fixed) {
+		if (index != this->data.end()) {
+			format = static_cast<block_format>(*index++);
+			if (format > block_format::compact) {
+				throw std::runtime_error("unsupported block format");
+			}
+		}
+	}
 private:
 	BlockManager& manager;
 	std::vector<std::byte> data;
 	std::vector<std::byte>::const_iterator index;
+	block_format format;
+public:
+	block_format GetFormat() const { return format; }
 public:
 	template<class T>
 	T access() {
@@ -88,6 +291,13 @@ public:
 		access(object);
 		return object;
 	}
+	DeserializeContext& skip(size_t size) {
+		if (static_cast<size_t>(data.end() - index) < size) {
+			throw std::runtime_error("deserialization error");
+		}
+		index += size;
+		return *this;
+	}
 	DeserializeContext& access(layout_trivial auto& object) {
 		if (data.end() < index + sizeof(object)) {
 			throw std::runtime_error("deserialization error");
@@ -100,10 +310,100 @@ public:
 	}
 	DeserializeContext& access(block_ref& object) {
 		ref_t ref;
-		access(ref);
+		if (format == block_format::compact) {
+			ref = access_varint();
+		} else {
+			access(ref);
+		}
 		object = block_ref_deserialize::construct(manager, ref);
 		return *this;
 	}
+	template<class T>
+	DeserializeContext& access(std::vector<T>& object) {
+		object.clear();
+		object.resize(std::is_empty_v<T> ? access_length() : access_span_size(1));
+		for (T& item : object) {
+			access(item);
+		}
+		return *this;
+	}
+	template<layout_contiguous T>
+	DeserializeContext& access(std::vector<T>& object) {
+		object.resize(access_span_size(sizeof(T)));
+		access_span(object.data(), object.size());
+		return *this;
+	}
+	DeserializeContext& access(std::string& object) {
+		object.resize(access_span_size(sizeof(char)));
+		access_span(object.data(), object.size());
+		return *this;
+	}
+	template<ref_type T>
+	DeserializeContext& access(std::vector<T>& object) {
+		object.clear();
+		object.resize(access_span_size(format == block_format::compact ? 1 : sizeof(ref_t)));
+		ref_t prev = 0;
+		for (block_ref& item : object) {
+			if (format == block_format::compact) {
+				prev += zigzag_decode(access_varint());
+				item = block_ref_deserialize::construct(manager, prev);
+			} else {
+				access(item);
+			}
+		}
+		return *this;
+	}
+	template<layout_static T>
+	DeserializeContext& access(T& object) {
+		if (format == block_format::compact) {
+			layout_traits<T>::write([&](auto& item) { access(item); }, object);
+			return *this;
+		}
+		if (static_cast<size_t>(data.end() - index) < flat_layout<T>::size) {
+			throw std::runtime_error("deserialization error");
+		}
+		const std::byte* data_begin = data.data() + (index - data.begin());
+		static_codec::decode(manager, object, data_begin);
+		index += flat_layout<T>::size;
+		return *this;
+	}
+private:
+	uint64 access_varint() {
+		uint64 value = 0;
+		for (unsigned shift = 0;; shift += 7) {
+			if (index == data.end() || shift > 63) {
+				throw std::runtime_error("deserialization error");
+			}
+			uint64 byte = static_cast<uint64>(*index++);
+			value |= (byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				return value;
+			}
+		}
+	}
+	size_t access_length() {
+		if (format == block_format::compact) {
+			return access_varint();
+		}
+		uint64 length;
+		access(length);
+		return length;
+	}
+	size_t access_span_size(size_t element_size) {
+		size_t size = access_length();
+		if (static_cast<size_t>(data.end() - index) / element_size < size) {
+			throw std::runtime_error("deserialization error");
+		}
+		return size;
+	}
+	template<class T>
+	void access_span(T* object, size_t size) {
+		if (size > 0) {
+			std::memcpy(object, data.data() + (index - data.begin()), size * sizeof(T));
+			index += size * sizeof(T);
+		}
+	}
+public:
 	DeserializeContext& access(auto& object) {
 		layout_traits<std::remove_cvref_t<decltype(object)>>::write([&](auto& item) { access(item); }, object);
 		return *this;
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../core/type.h"
+
+#include <atomic>
+#include <initializer_list>
+
+
+namespace BlockStore {
+
+
+struct CacheStats {
+	uint64 lookup = 0;
+	uint64 hit = 0;
+	uint64 miss = 0;
+	uint64 write = 0;
+	uint64 update = 0;
+	uint64 flush = 0;
+	uint64 flush_skipped = 0;
+	uint64 flush_bytes = 0;
+	uint64 swept = 0;
+	uint64 evicted = 0;
+	uint64 prefetch = 0;
+	uint64 entry_count = 0;
+	uint64 byte_count = 0;
+};
+
+
+struct CacheCounters {
+	std::atomic<uint64> lookup = 0;
+	std::atomic<uint64> hit = 0;
+	std::atomic<uint64> miss = 0;
+	std::atomic<uint64> write = 0;
+	std::atomic<uint64> update = 0;
+	std::atomic<uint64> flush = 0;
+	std::atomic<uint64> flush_skipped = 0;
+	std::atomic<uint64> flush_bytes = 0;
+	std::atomic<uint64> swept = 0;
+	std::atomic<uint64> evicted = 0;
+	std::atomic<uint64> prefetch = 0;
+
+	static void add(std::atomic<uint64>& counter, uint64 value = 1) { counter.fetch_add(value, std::memory_order_relaxed); }
+
+	void lookup_result(bool hit) { add(lookup); add(hit ? this->hit : miss); }
+	void flush_result(bool written, uint64 bytes) { add(written ? flush : flush_skipped); add(flush_bytes, bytes); }
+
+	CacheStats snapshot(uint64 entry_count = 0, uint64 byte_count = 0) const {
+		auto load = [](const std::atomic<uint64>& counter) { return counter.load(std::memory_order_relaxed); };
+		return CacheStats{
+			load(lookup), load(hit), load(miss), load(write), load(update),
+			load(flush), load(flush_skipped), load(flush_bytes), load(swept), load(evicted), load(prefetch),
+			entry_count, byte_count
+		};
+	}
+	void reset() {
+		for (std::atomic<uint64>* counter : { &lookup, &hit, &miss, &write, &update, &flush, &flush_skipped, &flush_bytes, &swept, &evicted, &prefetch }) {
+			counter->store(0, std::memory_order_relaxed);
+		}
+	}
+};
+
+
+} // namespace BlockStore
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "block.h"
+
+#include <string_view>
+#include <iterator>
+
+
+namespace BlockStore {
+
+
+class flat_view_base : protected block_ref_deserialize {
+protected:
+	flat_view_base(BlockManager& manager, const std::byte* data, const std::byte* limit) : manager(&manager), data(data), limit(limit) {}
+protected:
+	BlockManager* manager;
+	const std::byte* data;
+	const std::byte* limit;
+protected:
+	void check(size_t size) const {
+		if (data > limit || static_cast<size_t>(limit - data) < size) {
+			throw std::runtime_error("deserialization error");
+		}
+	}
+	template<class T>
+	T load(size_t offset) const {
+		std::array<std::byte, sizeof(T)> bytes;
+		std::memcpy(bytes.data(), data + offset, sizeof(T));
+		return std::bit_cast<T>(bytes);
+	}
+};
+
+
+template<class T>
+class flat_view;
+
+template<class T>
+size_t flat_skip(const flat_view<T>& view) {
+	if constexpr (flat_layout<T>::is_static) {
+		return flat_layout<T>::size;
+	} else {
+		return view.skip();
+	}
+}
+
+
+template<class T> requires layout_trivial<T>
+class flat_view<T> : public flat_view_base {
+public:
+	flat_view(BlockManager& manager, const std::byte* data, const std::byte* limit) : flat_view_base(manager, data, limit) { check(sizeof(T)); }
+public:
+	T get() const { return load<T>(0); }
+	operator T() const { return get(); }
+};
+
+template<>
+class flat_view<block_ref> : public flat_view_base {
+public:
+	flat_view(BlockManager& manager, const std::byte* data, const std::byte* limit) : flat_view_base(manager, data, limit) { check(sizeof(ref_t)); }
+public:
+	ref_t ref() const { return load<ref_t>(0); }
+	block_ref get() const { return construct(*manager, ref()); }
+};
+
+template<class T>
+class flat_view<block<T>> : public flat_view<block_ref> {
+public:
+	using flat_view<block_ref>::flat_view;
+public:
+	block<T> get() const { return flat_view<block_ref>::get(); }
+};
+
+template<>
+class flat_view<std::string> : public flat_view_base {
+public:
+	flat_view(BlockManager& manager, const std::byte* data, const std::byte* limit) : flat_view_base(manager, data, limit) {
+		check(sizeof(uint64));
+		if (static_cast<size_t>(limit - data) - sizeof(uint64) < size()) {
+			throw std::runtime_error("deserialization error");
+		}
+	}
+public:
+	size_t size() const { return static_cast<size_t>(load<uint64>(0)); }
+	size_t skip() const { return sizeof(uint64) + size(); }
+	std::string_view get() const { return std::string_view(reinterpret_cast<const char*>(data + sizeof(uint64)), size()); }
+	operator std::string_view() const { return get(); }
+};
+
+template<class T>
+class flat_view<std::vector<T>> : public flat_view_base {
+public:
+	flat_view(BlockManager& manager, const std::byte* data, const std::byte* limit) : flat_view_base(manager, data, limit) {
+		check(sizeof(uint64));
+		if constexpr (flat_layout<T>::is_static) {
+			if ((static_cast<size_t>(limit - data) - sizeof(uint64)) / flat_layout<T>::size < size()) {
+				throw std::runtime_error("deserialization error");
+			}
+		}
+	}
+public:
+	class iterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = flat_view<T>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = flat_view<T>;
+	private:
+		friend class flat_view;
+	private:
+		iterator(const flat_view& vector, size_t index, const std::byte* data) : vector(&vector), index(index), data(data) {}
+	public:
+		iterator() : vector(nullptr), index(0), data(nullptr) {}
+	private:
+		const flat_view* vector;
+		size_t index;
+		const std::byte* data;
+	public:
+		bool operator==(const iterator& other) const { return index == other.index; }
+		flat_view<T> operator*() const { return flat_view<T>(*vector->manager, data, vector->limit); }
+		iterator& operator++() { data += flat_skip(**this); index++; return *this; }
+		iterator operator++(int) { iterator it = *this; ++*this; return it; }
+	};
+public:
+	size_t size() const { return static_cast<size_t>(load<uint64>(0)); }
+	bool empty() const { return size() == 0; }
+	iterator begin() const { return iterator(*this, 0, data + sizeof(uint64)); }
+	iterator end() const { return iterator(*this, size(), nullptr); }
+	flat_view<T> operator[](size_t index) const {
+		if (index >= size()) {
+			throw std::invalid_argument("flat view index out of range");
+		}
+		if constexpr (flat_layout<T>::is_static) {
+			return flat_view<T>(*manager, data + sizeof(uint64) + index * flat_layout<T>::size, limit);
+		} else {
+			auto it = begin();
+			std::advance(it, index);
+			return *it;
+		}
+	}
+	size_t skip() const {
+		if constexpr (flat_layout<T>::is_static) {
+			return sizeof(uint64) + size() * flat_layout<T>::size;
+		} else {
+			size_t offset = sizeof(uint64);
+			for (auto item : *this) {
+				offset += flat_skip(item);
+			}
+			return offset;
+		}
+	}
+};
+
+template<class T1, class T2> requires (!layout_trivial<std::pair<T1, T2>>)
+class flat_view<std::pair<T1, T2>> : public flat_view_base {
+public:
+	flat_view(BlockManager& manager, const std::byte* data, const std::byte* limit) : flat_view_base(manager, data, limit) {}
+public:
+	flat_view<T1> first() const { return flat_view<T1>(*manager, data, limit); }
+	flat_view<T2> second() const { return flat_view<T2>(*manager, data + flat_skip(first()), limit); }
+	size_t skip() const { size_t offset = flat_skip(first()); return offset + flat_skip(flat_view<T2>(*manager, data + offset, limit)); }
+};
+
+template<class... Ts> requires (!layout_trivial<std::tuple<Ts...>>)
+class flat_view<std::tuple<Ts...>> : public flat_view_base {
+public:
+	flat_view(BlockManager& manager, const std::byte* data, const std::byte* limit) : flat_view_base(manager, data, limit) {}
+private:
+	template<size_t I>
+	size_t offset() const {
+		if constexpr (I == 0) {
+			return 0;
+		} else {
+			size_t offset = this->offset<I - 1>();
+			return offset + flat_skip(flat_view<std::tuple_element_t<I - 1, std::tuple<Ts...>>>(*manager, data + offset, limit));
+		}
+	}
+public:
+	template<size_t I>
+	flat_view<std::tuple_element_t<I, std::tuple<Ts...>>> get() const { return flat_view<std::tuple_element_t<I, std::tuple<Ts...>>>(*manager, data + offset<I>(), limit); }
+	size_t skip() const { return offset<sizeof...(Ts)>(); }
+};
+
+
+template<class T>
+class block_view_bytes {
+public:
+	block_view_bytes(const block<T>& ref) : manager(&ref.get_manager()), data(block_decompress(ref.block_ref::read())) {
+		if (data.empty()) {
+			throw std::invalid_argument("block data uninitialized");
+		}
+	}
+private:
+	BlockManager* manager;
+	std::vector<std::byte> data;
+public:
+	bool is_flat() const { return static_cast<block_format>(data.front()) == block_format::fixed; }
+	flat_view<T> get() const {
+		if (!is_flat()) {
+			throw std::invalid_argument("flat view requires fixed block format");
+		}
+		return flat_view<T>(*manager, data.data() + 1, data.data() + data.size());
+	}
+	T read() const { return DeserializeContext(*manager, data).access<T>(); }
+	decltype(auto) inspect(auto f) const { if (is_flat()) { return f(get()); } else { return f(read()); } }
+};
+
+
+} // namespace BlockStore
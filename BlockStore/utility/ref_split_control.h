@@ -6,13 +6,29 @@
 namespace BlockStore {
 
 
+struct RefSplitSize {
+	static const block_ref& ref(const block_ref& entry) { return entry; }
+	template<class T1, class T2>
+	static const block_ref& ref(const std::pair<T1, T2>& entry) { return entry.first; }
+	static block_format format(const auto& list) {
+		return list.empty() ? block_format::fixed : ref(list.front()).get_manager().get_block_format();
+	}
+	static size_t ref_size(const auto& list) {
+		return format(list) == block_format::compact ? varint_size(~ref_t(0)) : sizeof(ref_t);
+	}
+	static size_t size(const auto& list) {
+		return serialized_size(list, format(list));
+	}
+};
+
+
 template<>
 struct TreeSplitControl<block_ref, void> {
 	static bool node_should_split(const auto& keys) {
-		return sizeof(ref_t) + sizeof(size_t) + keys.size() * 2 * sizeof(ref_t) > block_size_limit;
+		return RefSplitSize::ref_size(keys) + RefSplitSize::size(keys) > block_size_limit;
 	}
 	static bool leaf_should_split(const auto& leaf) {
-		return sizeof(size_t) + leaf.size() * sizeof(ref_t) > block_size_limit;
+		return RefSplitSize::size(leaf) > block_size_limit;
 	}
 };
 
@@ -21,11 +37,7 @@ struct TreeSplitControl<block<Key>, void> : TreeSplitControl<block_ref, void> {}
 
 
 template<>
-struct TreeSplitControl<block_ref, block_ref> : TreeSplitControl<block_ref, void> {
-	static bool leaf_should_split(const auto& leaf) {
-		return sizeof(size_t) + leaf.size() * 2 * sizeof(ref_t) > block_size_limit;
-	}
-};
+struct TreeSplitControl<block_ref, block_ref> : TreeSplitControl<block_ref, void> {};
 
 template<class Key>
 struct TreeSplitControl<block<Key>, block_ref> : TreeSplitControl<block_ref, block_ref> {};
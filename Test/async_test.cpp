@@ -0,0 +1,68 @@
+#include "BlockStore/data/cache.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("async_test.db");
+	block<std::vector<block<int>>> root = block_manager.get_root();
+	std::vector<block<int>> ref_list;
+	block_manager.transaction([&] {
+		for (int i = 0; i < 10; ++i) {
+			ref_list.emplace_back(block_manager.allocate()).write(i);
+		}
+		root.write(ref_list);
+	});
+
+	// reads on the I/O threads
+	{
+		std::vector<std::future<int>> future_list;
+		for (auto& ref : ref_list) {
+			future_list.push_back(ref.read_async());
+		}
+		for (auto& future : future_list) {
+			std::cout << future.get() << ' ';
+		}
+		std::cout << std::endl;
+	}
+
+	// reads inserted into a cache on the calling thread
+	{
+		BlockCache<int> cache(block_manager);
+		auto first = cache.read_async(ref_list[0]);
+		first.get();
+		std::vector<block_view_future<int, BlockCache<int>>> future_list;
+		for (auto& ref : ref_list) {
+			future_list.push_back(cache.read_async(ref));
+		}
+		std::cout << future_list[0].ready() << ' ';  // cached, not fetched again
+		for (auto& future : future_list) {
+			std::cout << future.get().get() << ' ';
+		}
+		std::cout << std::endl;
+	}
+
+	// a read inside a transaction runs inline and sees its changes
+	block_manager.transaction([&] {
+		ref_list[0].write(100);
+		std::cout << ref_list[0].read_async().get() << std::endl;  // 100
+		ref_list[0].write(0);
+	});
+
+	// reads of missing blocks carry the error
+	try {
+		block<int>(block_manager.allocate()).read_async().get();
+	} catch (const std::invalid_argument& e) {
+		std::cout << e.what() << std::endl;
+	}
+
+	// synchronous reads
+	block_manager.set_io_thread_count(0);
+	std::future<int> future = ref_list[9].read_async();
+	std::cout << (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) << ' ' << future.get() << std::endl;  // 1 9
+
+	return 0;
+}
@@ -0,0 +1,85 @@
+#include "BlockStore/data/cache.h"
+
+#include <iostream>
+#include <algorithm>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("cache_test.db");
+	block<int> ref = block_manager.get_root();
+	ref.write(1);
+
+	// unchanged objects are not written again
+	{
+		BlockCache<int> cache(block_manager);
+		cache.read(ref).set(1);
+		std::cout << cache.statistics().flush << ' ' << cache.statistics().flush_skipped << std::endl;  // 0 1
+	}
+
+	// a write outside the cache makes its stored data stale
+	{
+		BlockCache<int> cache(block_manager);
+		cache.read(ref).get();
+		ref.write(2);
+		cache.read(ref).set(1);
+		std::cout << ref.read() << ' ' << cache.statistics().flush << std::endl;  // 1 1
+	}
+
+	// so does a write through another cache
+	{
+		BlockCacheDynamic cache(block_manager), other(block_manager);
+		cache.read(ref).get();
+		other.read(ref).set(3);
+		cache.read(ref).set(1);
+		std::cout << ref.read() << ' ' << cache.statistics().flush << std::endl;  // 1 1
+	}
+
+	// and an outer transaction rolled back after the cache has written
+	{
+		BlockCache<int> cache(block_manager);
+		try {
+			block_manager.transaction([&] {
+				cache.read(ref).set(5);
+				throw std::runtime_error("rollback");
+			});
+		} catch (const std::runtime_error& e) {
+			std::cout << e.what() << ' ' << ref.read() << ' ';  // rollback 1
+		}
+		cache.read(ref).set(5);
+		std::cout << ref.read() << ' ' << cache.statistics().flush << std::endl;  // 5 2
+	}
+
+	// the changed blocks are written in ascending order of their references, whatever the order of the changes
+	std::vector<block<int>> ref_list;
+	block_manager.transaction([&] {
+		for (int i = 0; i < 64; ++i) {
+			ref_list.emplace_back(block_manager.allocate()).write(i);
+		}
+	});
+	std::sort(ref_list.begin(), ref_list.end(), [](const block_ref& a, const block_ref& b) { return ref_t(a) < ref_t(b); });
+	auto ascending = [&] {
+		for (size_t i = 1; i < ref_list.size(); ++i) {
+			if (block_manager.get_write_stamp(ref_list[i - 1]) >= block_manager.get_write_stamp(ref_list[i])) { return false; }
+		}
+		return true;
+	};
+	{
+		BlockCache<int> cache(block_manager);
+		cache.transaction([&] {
+			for (size_t i = ref_list.size(); i-- > 0;) { cache.read(ref_list[i]).set(int(i) + 100); }
+		});
+		std::cout << ascending() << ' ';  // 1
+	}
+	{
+		BlockCacheDynamic cache(block_manager);
+		cache.transaction([&] {
+			for (size_t i = 0; i < ref_list.size(); ++i) { cache.read(ref_list[(i * 37) % ref_list.size()]).set(int(i) + 200); }
+		});
+		std::cout << ascending() << std::endl;  // 1
+	}
+
+	return 0;
+}
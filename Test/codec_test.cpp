@@ -0,0 +1,108 @@
+#include "BlockStore/data/block.h"
+
+#include <iostream>
+#include <chrono>
+
+
+using namespace BlockStore;
+
+
+struct StaticNode {
+	block<StaticNode> next;
+	block<StaticNode> prev;
+	uint64 key;
+	double value;
+
+	using layout_members = member_layout<&StaticNode::next, &StaticNode::prev, &StaticNode::key, &StaticNode::value>;
+	friend constexpr auto layout(layout_type<StaticNode>) { return layout_members::declare(); }
+};
+
+struct GenericNode {
+	block<GenericNode> next;
+	block<GenericNode> prev;
+	uint64 key;
+	double value;
+
+	friend constexpr auto layout(layout_type<GenericNode>) { return declare(&GenericNode::next, &GenericNode::prev, &GenericNode::key, &GenericNode::value); }
+};
+
+
+auto measure(auto f) {
+	auto begin = std::chrono::steady_clock::now();
+	f();
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+}
+
+template<class Node>
+void benchmark(BlockManager& block_manager, const char name[]) {
+	constexpr size_t count = 100000;
+	constexpr size_t block_count = 1000;
+
+	Node node{ block_manager.get_root(), block_manager.get_root(), 1, 1.0 };
+	auto codec = measure([&] {
+		for (size_t i = 0; i < count; ++i) {
+			node.key = i;
+			auto [data, ref_list] = SerializeContext(block_manager).access(node).Get();
+			node = DeserializeContext(block_manager, std::move(data)).access<Node>();
+			SerializeContext::Recycle({}, std::move(ref_list));
+		}
+	});
+
+	std::vector<block<Node>> block_list;
+	block_manager.transaction([&] {
+		for (size_t i = 0; i < block_count; ++i) {
+			block_list.push_back(block_manager.allocate());
+		}
+	});
+	auto write = measure([&] {
+		block_manager.transaction([&] {
+			for (size_t i = 0; i < block_count; ++i) {
+				node.key = i;
+				block_list[i].write(node);
+			}
+		});
+	});
+	uint64 sum = 0;
+	auto read = measure([&] {
+		for (size_t i = 0; i < block_count; ++i) {
+			sum += block_list[i].read().key;
+		}
+	});
+
+	std::cout << name << ": codec " << codec << "us, write " << write << "us, read " << read << "us, checksum " << sum << std::endl;
+}
+
+
+void check(BlockManager& block_manager) {
+	StaticNode static_node{ block_manager.get_root(), block_manager.allocate(), 42, 0.25 };
+	GenericNode generic_node{ block_manager.get_root(), static_node.prev, 42, 0.25 };
+	auto [static_data, static_ref_list] = SerializeContext(block_manager).access(static_node).Get();
+	auto [generic_data, generic_ref_list] = SerializeContext(block_manager).access(generic_node).Get();
+	std::cout << "same layout " << (static_data == generic_data && static_ref_list == generic_ref_list) << std::endl;
+
+	StaticNode node = DeserializeContext(block_manager, static_data).access<StaticNode>();
+	std::cout << "round trip " << ((ref_t)node.next == (ref_t)static_node.next && (ref_t)node.prev == (ref_t)static_node.prev && node.key == 42 && node.value == 0.25) << std::endl;
+
+	static_data.pop_back();
+	try {
+		DeserializeContext(block_manager, static_data).access<StaticNode>();
+	} catch (const std::runtime_error& e) {
+		std::cout << "truncated: " << e.what() << std::endl;
+	}
+}
+
+
+int main() {
+	BlockManager block_manager("codec_test.db");
+
+	static_assert(flat_layout<StaticNode>::is_static && flat_layout<StaticNode>::size == 32 && flat_layout<StaticNode>::ref_size == 2);
+	static_assert(!flat_layout<GenericNode>::is_static);
+
+	check(block_manager);
+	benchmark<StaticNode>(block_manager, "static");
+	benchmark<GenericNode>(block_manager, "generic");
+
+	block_manager.gc(GCOption{});
+
+	return 0;
+}
@@ -0,0 +1,68 @@
+#include "BlockStore/data/cache.h"
+
+#include <iostream>
+#include <thread>
+
+
+using namespace BlockStore;
+
+
+struct Record {
+	uint64 id;
+	std::string name;
+
+	using layout_members = member_layout<&Record::id, &Record::name>;
+	friend constexpr auto layout(layout_type<Record>) { return layout_members::declare(); }
+};
+
+
+int main() {
+	BlockManager block_manager("coherent_test.db");
+	block<Record> ref = block_manager.get_root();
+	ref.write({ 1, "one" });
+
+	BlockCache<Record> cache(block_manager, CacheOption{ .coherent = true });
+	BlockCacheDynamic other(block_manager, CacheOption{ .coherent = true });
+	auto view = cache.read(ref);
+
+	// a write through another cache is seen by the views of the registered caches
+	other.read(ref).set(Record{ 2, "two" });
+	std::cout << view.get().id << ' ' << view.get().name << std::endl;  // 2 two
+
+	// and so is a write through the block itself
+	ref.write({ 3, "three" });
+	std::cout << view.get().id << ' ' << other.read(ref).get().id << std::endl;  // 3 3
+
+	// a cache applies the writes of others at its next access, dropping the entries not in use and reading the others again
+	other.reset_statistics();
+	std::cout << ref.write_field<&Record::id>(4) << ' ' << view.get().id << ' ';  // 1 4
+	std::cout << other.read(ref).get().id << ' ' << other.statistics().miss << std::endl;  // 4 1
+
+	// changes rolled back after the caches have written them are restored, and are written again when repeated
+	try {
+		block_manager.transaction([&] {
+			view.update([](Record& record) { record.id = 5; });
+			std::cout << other.read(ref).get().id << ' ';  // 5
+			throw std::runtime_error("rollback");
+		});
+	} catch (const std::runtime_error& e) {
+		std::cout << e.what() << ' ';
+	}
+	std::cout << view.get().id << ' ' << other.read(ref).get().id << ' ' << ref.read().id << ' ';  // 4 4 4
+	view.update([](Record& record) { record.id = 5; });
+	std::cout << ref.read().id << ' ' << other.read(ref).get().id << std::endl;  // 5 5
+
+	// writes from another thread only queue the block for the caches, which are left to their own thread
+	std::thread writer([&] {
+		for (uint64 i = 6; i <= 1000; ++i) { ref.write({ i, "many" }); }
+	});
+	uint64 last = 0; bool ordered = true;
+	for (size_t i = 0; i < 10000 && last < 1000; ++i) {
+		uint64 id = view.get().id;
+		ordered = ordered && id >= last; last = id;
+	}
+	writer.join();
+	std::cout << ordered << ' ' << view.get().id << ' ' << view.get().name << std::endl;  // 1 1000 many
+
+	return 0;
+}
@@ -0,0 +1,90 @@
+#include "BlockStore/data/block.h"
+#include "CppSerialize/stl/string.h"
+
+#include <iostream>
+#include <random>
+
+
+using namespace BlockStore;
+
+
+std::vector<std::byte> make_data(size_t size, auto f) {
+	std::vector<std::byte> data(size);
+	for (size_t i = 0; i < size; ++i) {
+		data[i] = static_cast<std::byte>(f(i));
+	}
+	return data;
+}
+
+bool round_trip(const std::vector<std::byte>& data) {
+	std::vector<std::byte> compressed, output;
+	lz_compress(data.data(), data.size(), compressed);
+	lz_decompress(compressed.data(), compressed.size(), output);
+	return output == data;
+}
+
+
+int main() {
+	std::mt19937 random(2026);
+
+	// round trips
+	std::vector<std::vector<std::byte>> input_list = {
+		{},
+		make_data(3, [](size_t i) { return i; }),
+		make_data(1000, [](size_t i) { return 'a'; }),
+		make_data(1000, [](size_t i) { return i % 7; }),
+		make_data(4096, [&](size_t i) { return random(); }),
+		make_data(100000, [&](size_t i) { return i % 70000 < 300 ? random() % 4 : i / 300; }),
+	};
+	for (auto& data : input_list) {
+		std::cout << round_trip(data);
+	}
+	std::cout << std::endl;
+
+	// corrupt input is rejected without reading or writing out of bounds
+	std::vector<std::byte> data = make_data(1000, [](size_t i) { return i % 13; }), compressed;
+	lz_compress(data.data(), data.size(), compressed);
+	auto try_decompress = [&](const std::vector<std::byte>& input) {
+		try {
+			std::vector<std::byte> output;
+			lz_decompress(input.data(), input.size(), output);
+			return output == data;
+		} catch (const std::runtime_error&) {
+			return true;
+		}
+	};
+	size_t wrong = 0;
+	for (size_t size = 0; size < compressed.size(); ++size) {
+		wrong += !try_decompress(std::vector<std::byte>(compressed.begin(), compressed.begin() + size));
+	}
+	std::cout << wrong << std::endl;  // 0, truncations are rejected or lose nothing
+	for (size_t i = 0; i < 10000; ++i) {
+		std::vector<std::byte> input = compressed;
+		input[random() % input.size()] ^= static_cast<std::byte>(1 + random() % 255);
+		try_decompress(input);
+		try_decompress(make_data(random() % 64, [&](size_t) { return random(); }));
+	}
+	std::cout << "fuzzed" << std::endl;
+
+	// blocks
+	BlockManager block_manager("compress_test.db");
+	block<std::string> root = block_manager.get_root();
+	std::string text(3000, 'x');
+	for (size_t i = 0; i < text.size(); i += 10) { text[i] = 'a' + i % 26; }
+	block_manager.set_block_compression(block_compression::lz);
+	size_t size = root.write(text);
+	std::cout << (size < text.size()) << ' ' << (root.read() == text) << std::endl;  // 1 1
+	block_manager.set_block_compression(block_compression::none);
+	std::cout << (root.read() == text) << std::endl;  // 1
+	std::string large(8000, 'y');
+	try {
+		root.write(large);
+	} catch (const std::invalid_argument& e) {
+		std::cout << e.what() << std::endl;
+	}
+	block_manager.set_block_compression(block_compression::lz);
+	root.write(large);
+	std::cout << (root.read() == large) << std::endl;  // 1
+
+	return 0;
+}
@@ -0,0 +1,74 @@
+#include "BlockStore/data/cache.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("eviction_test.db");
+	std::vector<block<uint64>> ref_list;
+	block_manager.transaction([&] {
+		for (uint64 i = 0; i < 100; ++i) {
+			ref_list.emplace_back(block_manager.allocate()).write(i);
+		}
+	});
+
+	// entries not in use are evicted to stay within the limit
+	{
+		BlockCache<uint64> cache(block_manager, CacheOption{ .entry_limit = 8 });
+		uint64 sum = 0;
+		for (auto& ref : ref_list) { sum += cache.read(ref).get(); }
+		std::cout << sum << ' ' << cache.statistics().entry_count << ' ' << cache.statistics().evicted << std::endl;  // 4950 8 92
+
+		// entries hit since the hand passed get a second chance
+		cache.read(ref_list[99]).get();
+		cache.read(ref_list[0]).get();
+		cache.reset_statistics();
+		cache.read(ref_list[99]).get();
+		std::cout << cache.statistics().hit << std::endl;  // 1
+	}
+
+	// new entries take the place of the evicted ones behind the hand, so they stay until it comes around again
+	{
+		BlockCache<uint64> cache(block_manager, CacheOption{ .entry_limit = 10 });
+		for (size_t i = 0; i < 15; ++i) { cache.read(ref_list[i]).get(); }
+		cache.reset_statistics();
+		for (size_t i = 10; i < 15; ++i) { cache.read(ref_list[i]).get(); }
+		std::cout << cache.statistics().hit << ' ' << cache.statistics().miss << ' ';  // 5 0
+		for (size_t i = 15; i < 20; ++i) { cache.read(ref_list[i]).get(); }
+		cache.reset_statistics();
+		for (size_t i = 10; i < 20; ++i) { cache.read(ref_list[i]).get(); }
+		std::cout << cache.statistics().hit << ' ' << cache.statistics().miss << std::endl;  // 10 0
+	}
+
+	// entries in use or changed in the ongoing transaction are kept
+	{
+		BlockCache<uint64> cache(block_manager, CacheOption{ .entry_limit = 8 });
+		std::vector<block_view<uint64, BlockCache<uint64>>> view_list;
+		for (size_t i = 0; i < 10; ++i) { view_list.push_back(cache.read(ref_list[i])); }
+		cache.read(ref_list[10]).get();
+		std::cout << cache.statistics().entry_count << ' ';  // 11
+		view_list.clear();
+		cache.read(ref_list[11]).get();
+		std::cout << cache.statistics().entry_count << ' ';  // 8
+		cache.transaction([&] {
+			for (size_t i = 20; i < 40; ++i) { cache.read(ref_list[i]).set(i * 2); }
+			std::cout << cache.statistics().entry_count << ' ';  // 20
+		});
+		cache.read(ref_list[0]).get();
+		std::cout << cache.statistics().entry_count << ' ' << ref_list[39].read() << std::endl;  // 8 78
+	}
+
+	// a byte limit bounds the estimated size of the entries
+	{
+		BlockCacheDynamic cache(block_manager, CacheOption{ .byte_limit = block_size_limit });
+		uint64 sum = 0;
+		for (auto& ref : ref_list) { sum += cache.read(ref).get(); }
+		CacheStats stats = cache.statistics();
+		std::cout << (stats.byte_count <= block_size_limit) << ' ' << (stats.entry_count > 0) << ' ' << (stats.entry_count + stats.evicted) << std::endl;  // 1 1 100
+	}
+
+	return 0;
+}
@@ -0,0 +1,64 @@
+#include "BlockStore/data/cache.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+struct Record {
+	uint64 id;
+	block_ref link;
+	double weight;
+	std::string name;
+
+	using layout_members = member_layout<&Record::id, &Record::link, &Record::weight, &Record::name>;
+	friend constexpr auto layout(layout_type<Record>) { return layout_members::declare(); }
+};
+
+
+int main() {
+	BlockManager block_manager("field_test.db");
+	block<std::tuple<>>(block_manager.get_root()).write({});
+
+	// a field written in place leaves the block as a full rewrite would, whatever the stored format
+	struct Case { const char* name; block_format stored_format, format; block_compression compression; };
+	for (auto [name, stored_format, format, compression] : {
+		Case{ "fixed", block_format::fixed, block_format::fixed, block_compression::none },
+		Case{ "compact", block_format::compact, block_format::compact, block_compression::none },
+		Case{ "compressed", block_format::fixed, block_format::fixed, block_compression::lz },
+		Case{ "stored compact", block_format::compact, block_format::fixed, block_compression::none },
+	}) {
+		block_ref target = block_manager.allocate();
+		block<Record> ref = block_manager.allocate(), expected = block_manager.allocate();
+		block_manager.set_block_format(stored_format);
+		block_manager.set_block_compression(compression);
+		ref.write({ 7, block_manager.get_root(), 2.5, std::string(200, 'r') });
+		block_manager.set_block_format(format);
+		{
+			BlockCache<Record> cache(block_manager);
+			cache.read_lazy(ref).set_field<&Record::id>(8);
+			cache.read_lazy(ref).set_field<&Record::link>(target);
+			std::cout << name << ' ' << cache.statistics().flush << ' ';
+		}
+		expected.write({ 8, target, 2.5, std::string(200, 'r') });
+		Record record = ref.read();
+		std::cout << record.id << ' ' << ((ref_t)record.link == (ref_t)target) << ' ' << (ref.block_ref::read() == expected.block_ref::read()) << std::endl;  // 2 8 1 1
+	}
+	block_manager.set_block_format(block_format::fixed);
+	block_manager.set_block_compression(block_compression::none);
+
+	// the references written in place are kept alive by the garbage collector
+	block<Record> ref = block_manager.get_root();
+	ref.write({ 1, block_manager.get_root(), 0.0, "root" });
+	{
+		block<int> target = block_manager.allocate();
+		target.write(1);
+		std::cout << ref.write_field<&Record::link>(block_ref(target)) << ' ';
+	}
+	block_manager.gc(GCOption{});
+	block_manager.gc(GCOption{});
+	std::cout << block<int>(ref.read_field<&Record::link>()).read() << std::endl;  // 1 1
+
+	return 0;
+}
@@ -0,0 +1,76 @@
+#include "BlockStore/Item/UnorderedRefSet.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("format_test.db");
+	BlockCacheDynamic cache(block_manager);
+	block<std::tuple<>>(block_manager.get_root()).write({});
+
+	std::vector<block_ref> ref_list;
+	auto count = [&](UnorderedRefSet<BlockCacheDynamicAdapter>& set) {
+		size_t count = 0;
+		for (auto& ref : ref_list) { count += set.contains(ref); }
+		return count;
+	};
+
+	{
+		UnorderedRefSet<BlockCacheDynamicAdapter> set(cache, cache, block_manager.get_root());
+
+		// leaves split by their compact size hold several times more than fits in the fixed format
+		block_manager.set_block_format(block_format::compact);
+		cache.transaction([&] {
+			for (size_t i = 0; i < 6000; ++i) {
+				set.insert(ref_list.emplace_back(block_manager.allocate()));
+			}
+		});
+		std::cout << count(set) << std::endl;  // 6000
+
+		// and are still written in the compact format after switching back
+		block_manager.set_block_format(block_format::fixed);
+		cache.transaction([&] {
+			for (size_t i = 0; i < 6000; i += 3) {
+				set.erase(ref_list[i]);
+			}
+		});
+		std::cout << count(set) << std::endl;  // 4000
+	}
+	cache.sweep();
+
+	{
+		BlockCacheDynamic cache(block_manager);
+		UnorderedRefSet<BlockCacheDynamicAdapter> set(cache, cache, block_manager.get_root());
+		std::cout << count(set) << std::endl;  // 4000
+
+		// new leaves are split by their fixed size
+		cache.transaction([&] {
+			for (size_t i = 0; i < 6000; i += 3) {
+				set.insert(ref_list[i]);
+			}
+		});
+		std::cout << count(set) << std::endl;  // 6000
+
+		block_manager.set_block_format(block_format::compact);
+		cache.transaction([&] {
+			for (size_t i = 1; i < 6000; i += 3) {
+				set.erase(ref_list[i]);
+			}
+		});
+		std::cout << count(set) << std::endl;  // 4000
+		cache.sweep();
+	}
+
+	// only the lengths of vectors and strings are varints in the compact format, so the bytes don't depend on the integer types of the platform
+	{
+		block<std::pair<uint64, std::vector<std::pair<size_t, std::string>>>> ref = block_manager.allocate();
+		ref.write({ 300, { { 1, "ab" } } });
+		for (std::byte byte : ref.block_ref::read()) { std::cout << std::hex << int(byte) << ' '; }
+		std::cout << std::dec << std::endl;  // 1 2c 1 0 0 0 0 0 0 1 1 0 0 0 0 0 0 0 2 61 62
+	}
+
+	return 0;
+}
@@ -0,0 +1,93 @@
+#include "BlockStore/data/block.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("group_commit_test.db");
+	block<int> root = block_manager.get_root();
+	root.write(0);
+
+	BlockManager reader("group_commit_test.db");
+	auto read = [&] { return block<int>(reader.get_root()).read(); };
+	auto state = [](std::shared_future<void> future) {
+		return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready ? "committed" : "pending";
+	};
+
+	// count limit
+	block_manager.enable_group_commit(GroupCommitOption{ .count_limit = 3, .time_limit = std::chrono::hours(1) });
+	block_manager.transaction([&] { root.write(1); });
+	block_manager.transaction([&] { root.write(2); });
+	std::shared_future<void> future = block_manager.pending_commit();
+	std::cout << state(future) << ' ' << read() << std::endl;  // pending 0
+	block_manager.transaction([&] { root.write(3); });
+	std::cout << state(future) << ' ' << read() << std::endl;  // committed 3
+
+	// time limit
+	block_manager.enable_group_commit(GroupCommitOption{ .count_limit = 256, .time_limit = std::chrono::milliseconds(50) });
+	block_manager.transaction([&] { root.write(4); });
+	future = block_manager.pending_commit();
+	std::cout << state(future) << std::endl;  // pending
+	future.wait();
+	std::cout << state(future) << ' ' << read() << std::endl;  // committed 4
+
+	// a merged transaction rolled back alone
+	block_manager.enable_group_commit(GroupCommitOption{ .count_limit = 256, .time_limit = std::chrono::hours(1) });
+	block_manager.transaction([&] { root.write(5); });
+	try {
+		block_manager.transaction([&] {
+			root.write(6);
+			throw std::runtime_error("merged transaction");
+		});
+	} catch (const std::runtime_error& e) {
+		std::cout << "rolled back: " << e.what() << std::endl;
+	}
+	future = block_manager.pending_commit();
+	block_manager.flush();
+	std::cout << state(future) << ' ' << read() << std::endl;  // committed 5
+
+	// a failed commit reaches the waiters
+	block_manager.transaction([&] { root.write(7); });
+	future = block_manager.pending_commit();
+	try {
+		reader.transaction([&] {
+			read();  // holds the shared lock, so the commit can't complete
+			block_manager.flush();
+		});
+	} catch (const std::runtime_error&) {
+		std::cout << "flush failed" << std::endl;
+	}
+	try {
+		future.get();
+	} catch (const std::runtime_error&) {
+		std::cout << "commit failed" << std::endl;
+	}
+	std::cout << root.read() << ' ' << read() << std::endl;  // 5 5
+
+	// and the transaction that reaches the limit
+	block_manager.enable_group_commit(GroupCommitOption{ .count_limit = 2, .time_limit = std::chrono::hours(1) });
+	block_manager.transaction([&] { root.write(7); });
+	future = block_manager.pending_commit();
+	try {
+		reader.transaction([&] {
+			read();
+			block_manager.transaction([&] { root.write(8); });
+		});
+	} catch (const std::runtime_error&) {
+		std::cout << "transaction failed" << std::endl;
+	}
+	std::cout << (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) << ' ' << root.read() << ' ' << read() << std::endl;  // 1 5 5
+	block_manager.enable_group_commit(GroupCommitOption{ .count_limit = 256, .time_limit = std::chrono::hours(1) });
+
+	// disabling commits the pending group
+	block_manager.transaction([&] { root.write(8); });
+	future = block_manager.pending_commit();
+	std::cout << state(future) << std::endl;  // pending
+	block_manager.disable_group_commit();
+	std::cout << state(future) << ' ' << read() << std::endl;  // committed 8
+
+	return 0;
+}
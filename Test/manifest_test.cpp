@@ -0,0 +1,62 @@
+#include "BlockStore/data/cache.h"
+
+#include <fstream>
+#include <algorithm>
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("manifest_test.db");
+	std::vector<block<uint64>> ref_list;
+	block_manager.transaction([&] {
+		for (uint64 i = 0; i < 10; ++i) {
+			ref_list.emplace_back(block_manager.allocate()).write(i);
+		}
+	});
+
+	// the blocks hit the most are saved
+	{
+		BlockCache<uint64> cache(block_manager);
+		for (size_t i = 0; i < 10; ++i) {
+			for (size_t j = 0; j <= i; ++j) { cache.read(ref_list[i]).get(); }
+		}
+		cache.save_manifest("manifest_test.manifest", 4);
+		for (ref_t ref : CacheManifest::load("manifest_test.manifest")) {
+			std::cout << std::find_if(ref_list.begin(), ref_list.end(), [&](const block_ref& item) { return item == ref; })->read() << ' ';
+		}
+		std::cout << std::endl;  // 9 8 7 6
+	}
+
+	// and read back into a new cache, leaving out the ones changed in the meantime
+	{
+		BlockCache<uint64> cache(block_manager);
+		cache.load_manifest("manifest_test.manifest");
+		cache.read(ref_list[9]).set(90);
+		cache.wait_warm_up();
+		std::cout << cache.statistics().entry_count << ' ' << cache.statistics().prefetch << ' ';  // 4 0
+		cache.reset_statistics();
+		uint64 sum = 0;
+		for (size_t i = 6; i < 10; ++i) { sum += cache.read(ref_list[i]).get(); }
+		std::cout << sum << ' ' << cache.statistics().hit << std::endl;  // 111 4
+	}
+
+	// damaged files load nothing
+	std::vector<char> file;
+	{
+		std::ifstream stream("manifest_test.manifest", std::ios::binary);
+		file.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+	auto load = [&](std::vector<char> content) {
+		std::ofstream("manifest_test.manifest", std::ios::binary | std::ios::trunc).write(content.data(), content.size());
+		return CacheManifest::load("manifest_test.manifest").size();
+	};
+	std::vector<char> truncated(file.begin(), file.end() - 8), corrupt = file, version = file;
+	corrupt[20] ^= 1; version[0] ^= 1;
+	std::cout << load(file) << ' ' << load(truncated) << ' ' << load(corrupt) << ' ' << load(version) << ' ' << load({}) << ' ' << CacheManifest::load("missing.manifest").size() << std::endl;  // 4 0 0 0 0 0
+	std::remove("manifest_test.manifest");
+
+	return 0;
+}
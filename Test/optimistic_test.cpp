@@ -0,0 +1,110 @@
+#include "BlockStore/Item/List.h"
+#include "common.h"
+
+#include <thread>
+#include <future>
+
+
+using namespace BlockStore;
+
+
+struct Root {
+	block<int> counter;
+	block_ref list_a;
+	block_ref list_b;
+
+	friend constexpr auto layout(layout_type<Root>) { return declare(&Root::counter, &Root::list_a, &Root::list_b); }
+};
+
+
+int main() {
+	BlockManager block_manager("optimistic_test.db");
+
+	block<Root> root_ref = block_manager.get_root();
+	Root root = root_ref.read([&] { return Root{ block_manager.allocate(), block_manager.allocate(), block_manager.allocate() }; });
+	root.counter.write(0);
+	block<std::tuple<>>(root.list_a).write({});
+	block<std::tuple<>>(root.list_b).write({});
+
+	auto worker = [&](const block_ref& list_root, int base) {
+		for (int i = 0; i < 20; ++i) {
+			block_manager.optimistic_transaction([&] {
+				BlockCache<ListNode<int>> cache(block_manager);
+				List<int, BlockCache> list(cache, list_root);
+				list.emplace_back(base + i);
+			});
+			block_manager.optimistic_transaction([&] {
+				root.counter.write(root.counter.read() + 1);
+			});
+		}
+	};
+
+	std::thread a(worker, std::cref(root.list_a), 0);
+	std::thread b(worker, std::cref(root.list_b), 100);
+	a.join();
+	b.join();
+
+	std::cout << root.counter.read() << std::endl;
+
+	// a nested transaction or savepoint rolled back inside the body discards its buffered writes
+	block_manager.optimistic_transaction([&] {
+		root.counter.write(1000);
+		try {
+			block_manager.transaction([&] {
+				root.counter.write(2000);
+				throw std::runtime_error("nested");
+			});
+		} catch (const std::runtime_error&) {}
+		try {
+			block_manager.savepoint([&] {
+				root.counter.write(3000);
+				throw std::runtime_error("nested");
+			});
+		} catch (const std::runtime_error&) {}
+	});
+	std::cout << root.counter.read() << std::endl;
+	{
+		BlockCache<ListNode<int>> cache(block_manager);
+		print(List<int, BlockCache>(cache, root.list_a));
+		print(List<int, BlockCache>(cache, root.list_b));
+	}
+
+	// objects found in a cache created before the body are validated as well
+	{
+		BlockCache<int> cache(block_manager, CacheOption{ .coherent = true });
+		block<int> copy = block_manager.allocate();
+		cache.read(root.counter).get();
+		int attempt = 0;
+		block_manager.optimistic_transaction([&] {
+			int value = cache.read(root.counter).get();
+			if (attempt++ == 0) {
+				std::thread([&] { root.counter.write(value + 1); }).join();
+			}
+			copy.write(value);
+		});
+		std::cout << attempt << ' ' << copy.read() << std::endl;  // 2 1001
+	}
+
+	// a buffered transaction doesn't keep other threads from reading while its body runs
+	block_manager.set_transaction_mode(transaction_mode::buffered);
+	{
+		std::promise<void> written, read;
+		std::thread writer([&] {
+			block_manager.transaction([&] {
+				root.counter.write(4000);
+				written.set_value();
+				read.get_future().wait();
+			});
+		});
+		written.get_future().wait();
+		std::cout << root.counter.read() << ' ';  // 1001
+		read.set_value();
+		writer.join();
+		std::cout << root.counter.read() << std::endl;  // 4000
+	}
+	block_manager.set_transaction_mode(transaction_mode::exclusive);
+
+	block_manager.gc(GCOption{});
+
+	return 0;
+}
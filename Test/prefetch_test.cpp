@@ -0,0 +1,83 @@
+#include "BlockStore/Item/Tree.h"
+#include "BlockStore/Item/List.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("prefetch_test.db");
+	block<std::tuple<>>(block_manager.get_root()).write({});
+	std::vector<block<uint64>> ref_list;
+	block_manager.transaction([&] {
+		for (uint64 i = 0; i < 300; ++i) {
+			ref_list.emplace_back(block_manager.allocate()).write(i);
+		}
+	});
+
+	// blocks not cached yet are read in batches and inserted without being kept in use
+	{
+		BlockCache<uint64> cache(block_manager);
+		cache.read(ref_list[0]).get();
+		std::vector<block<uint64>> prefetch_list = ref_list;
+		prefetch_list.push_back(block_manager.allocate());  // not written, so skipped
+		cache.prefetch(prefetch_list);
+		std::cout << cache.statistics().prefetch << ' ' << cache.statistics().entry_count << ' ';  // 299 300
+		cache.prefetch(ref_list);
+		cache.reset_statistics();
+		uint64 sum = 0;
+		for (auto& ref : ref_list) { sum += cache.read(ref).get(); }
+		std::cout << sum << ' ' << cache.statistics().prefetch << ' ' << cache.statistics().miss << ' ';  // 44850 0 0
+		cache.sweep();
+		std::cout << cache.statistics().entry_count << std::endl;  // 0
+	}
+	{
+		BlockCacheDynamic cache(block_manager);
+		cache.prefetch<uint64>(ref_list);
+		cache.reset_statistics();
+		for (auto& ref : ref_list) { cache.read(ref).get(); }
+		std::cout << cache.statistics().hit << ' ' << cache.statistics().miss << std::endl;  // 300 0
+	}
+
+	// range iteration of a tree prefetches the next leaves of each node
+	{
+		using IntTree = Tree<int, void, std::less<int>, BlockCache>;
+		{
+			BlockCache<TreeNode<int>> node_cache(block_manager);
+			BlockCache<TreeLeaf<int, void>> leaf_cache(block_manager);
+			IntTree tree(node_cache, leaf_cache, block_manager.get_root(), std::less<int>());
+			for (int i = 0; i < 200; ++i) {
+				tree.insert(tree.lower_bound(i), i);
+			}
+		}
+		BlockCache<TreeNode<int>> node_cache(block_manager);
+		BlockCache<TreeLeaf<int, void>> leaf_cache(block_manager);
+		IntTree tree(node_cache, leaf_cache, block_manager.get_root(), std::less<int>());
+		int sum = 0;
+		for (int i : tree) { sum += i; }
+		CacheStats stats = leaf_cache.statistics();
+		std::cout << sum << ' ' << (stats.prefetch > 0) << ' ' << (stats.miss + stats.prefetch == stats.entry_count) << ' ' << (stats.miss < stats.prefetch) << std::endl;  // 19900 1 1 1
+	}
+
+	// iteration of a list reads the next node while the current one is used
+	{
+		block_ref list_root = block_manager.allocate();
+		{
+			BlockCache<ListNode<int>> cache(block_manager);
+			List<int, BlockCache> list(cache, list_root);
+			cache.transaction([&] {
+				for (int i = 0; i < 50; ++i) { list.emplace_back(i); }
+			});
+		}
+		BlockCache<ListNode<int>> cache(block_manager);
+		List<int, BlockCache> list(cache, list_root);
+		int sum = 0;
+		for (auto value : list) { sum += value.get(); }
+		CacheStats stats = cache.statistics();
+		std::cout << sum << ' ' << stats.miss << ' ' << stats.entry_count << std::endl;  // 1225 1 50
+	}
+
+	return 0;
+}
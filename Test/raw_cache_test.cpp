@@ -0,0 +1,53 @@
+#include "BlockStore/data/block.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("raw_cache_test.db"), other("raw_cache_test.db");
+	block<uint64> ref = block_manager.get_root(), other_ref = other.get_root();
+	ref.write(0);
+	std::vector<block<uint64>> ref_list;
+	block_manager.transaction([&] {
+		for (uint64 i = 0; i < 16; ++i) {
+			ref_list.emplace_back(block_manager.allocate()).write(i);
+		}
+	});
+
+	// reads are served from the cache, so a change by another connection isn't seen
+	block_manager.enable_raw_cache(1024);
+	ref.read();
+	other_ref.write(100);
+	std::cout << ref.read() << ' ';  // 0
+
+	// writes go through the cache
+	ref.write(1);
+	std::cout << ref.read() << ' ' << other_ref.read() << ' ';  // 1 1
+
+	// and a rolled back transaction clears it
+	try {
+		block_manager.transaction([&] {
+			ref.write(2);
+			throw std::runtime_error("rollback");
+		});
+	} catch (const std::runtime_error&) {}
+	other_ref.write(3);
+	std::cout << ref.read() << std::endl;  // 3
+
+	// the least recently used blocks are evicted to stay within the limit
+	ref.read();
+	for (auto& ref : ref_list) { ref.read(); }
+	other_ref.write(4);
+	std::cout << ref.read() << ' ';  // 4
+
+	// and disabling the cache reads from the database again
+	ref.read();
+	other_ref.write(5);
+	block_manager.disable_raw_cache();
+	std::cout << ref.read() << std::endl;  // 5
+
+	return 0;
+}
@@ -0,0 +1,48 @@
+#include "BlockStore/Item/Tree.h"
+
+#include <iostream>
+#include <random>
+
+
+using namespace BlockStore;
+
+
+using IntTree = Tree<int, void, std::less<int>, BlockCacheDynamicAdapter>;
+
+
+int main() {
+	BlockManager block_manager("resident_test.db");
+	block<std::tuple<>>(block_manager.get_root()).write({});
+	{
+		BlockCacheDynamic cache(block_manager);
+		IntTree tree(cache, cache, block_manager.get_root(), std::less<int>());
+		cache.transaction([&] {
+			for (int i = 0; i < 300; ++i) {
+				tree.insert(tree.end(), i);
+			}
+		});
+		std::cout << cache.statistics().entry_count << std::endl;  // 296
+	}
+
+	// random lookups through a cache shared by nodes and leaves, so that leaves keep evicting other entries
+	auto lookup = [&](size_t limit, bool resident) {
+		BlockCacheDynamic cache(block_manager, CacheOption{ .entry_limit = limit });
+		cache.set_resident<TreeNode<int>>(resident);
+		IntTree tree(cache, cache, block_manager.get_root(), std::less<int>());
+		std::mt19937 random(0);
+		int sum = 0;
+		for (int i = 0; i < 1000; ++i) {
+			sum += *tree.lower_bound(int(random() % 300)) >= 0;
+		}
+		std::cout << sum << ' ' << cache.statistics().entry_count << ' ' << cache.statistics().miss << std::endl;
+	};
+
+	// resident nodes stay cached while the leaves are evicted, so once the nodes fit a lookup mostly misses only its leaf
+	lookup(160, false);  // 1000 160 1541
+	lookup(160, true);  // 1000 160 1028
+
+	// and they are evicted too when there is nothing else left to keep the cache within the limit
+	lookup(64, true);  // 1000 64 3502
+
+	return 0;
+}
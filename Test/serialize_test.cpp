@@ -0,0 +1,91 @@
+#include "BlockStore/data/cache.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+struct Item {
+	block_ref ref;
+	std::string name;
+	std::vector<uint64> value_list;
+
+	friend constexpr auto layout(layout_type<Item>) { return declare(&Item::ref, &Item::name, &Item::value_list); }
+};
+
+struct Record {
+	uint64 id;
+	block_ref link;
+	double weight;
+	std::string name;
+
+	using layout_members = member_layout<&Record::id, &Record::link, &Record::weight, &Record::name>;
+	friend constexpr auto layout(layout_type<Record>) { return layout_members::declare(); }
+};
+
+std::ostream& operator<<(std::ostream& os, const Item& item) {
+	os << (ref_t)item.ref << ' ' << item.name;
+	for (uint64 value : item.value_list) { os << ' ' << value; }
+	return os;
+}
+
+
+int main() {
+	BlockManager block_manager("serialize_test.db");
+	block<Item> root = block_manager.get_root();
+
+	// buffers are presized and returned to the pool after the write
+	{
+		Item item{ block_manager.get_root(), "item", { 1, 2, 3 } };
+		size_t size = root.write(item);
+		std::cout << root.read() << std::endl;
+		std::vector<std::byte> buffer = buffer_pool<std::byte>::acquire(0);
+		std::cout << size << ' ' << (buffer.capacity() >= size) << std::endl;  // 1
+		buffer_pool<std::byte>::release(std::move(buffer));
+	}
+
+	// the size limit is checked before serializing, and the block is left unchanged
+	try {
+		root.write(Item{ block_manager.get_root(), std::string(block_size_limit, 'x'), {} });
+	} catch (const std::invalid_argument& e) {
+		std::cout << e.what() << std::endl;
+	}
+	std::cout << root.read() << std::endl;
+
+	// contiguous ranges are copied as one span, in the same layout as element by element
+	{
+		block<std::pair<std::vector<double>, std::string>> ref = block_manager.allocate();
+		std::vector<double> value_list = { 0.5, 1.5, -2.0 };
+		std::string text = "contiguous";
+		ref.write({ value_list, text });
+		std::vector<std::byte> expected = { std::byte(block_format::fixed) };
+		auto append = [&](const auto& value) {
+			auto bytes = std::bit_cast<std::array<std::byte, sizeof(value)>>(value);
+			expected.insert(expected.end(), bytes.begin(), bytes.end());
+		};
+		append(value_list.size()); for (double value : value_list) { append(value); }
+		append(text.size()); for (char c : text) { append(c); }
+		std::cout << (ref.block_ref::read() == expected) << std::endl;  // 1
+		auto [value_list_read, text_read] = ref.read();
+		std::cout << (value_list_read == value_list) << ' ' << text_read << std::endl;  // 1 contiguous
+		ref.write({});
+		std::cout << ref.read().first.size() << ' ' << ref.read().second.size() << std::endl;  // 0 0
+	}
+
+	// single fields are read at their offsets, or from the whole object in the compact format
+	for (block_format format : { block_format::fixed, block_format::compact }) {
+		block_manager.set_block_format(format);
+		block<Record> ref = block_manager.allocate();
+		ref.write({ 7, block_manager.get_root(), 2.5, "record" });
+		std::cout << ref.read_field<&Record::id>() << ' ' << (ref_t)ref.read_field<&Record::link>() << ' ' << ref.read_field<&Record::weight>() << std::endl;  // 7 1 2.5
+		BlockCache<Record> cache(block_manager);
+		std::cout << cache.read_lazy(ref).get_field<&Record::id>() << ' ' << cache.statistics().entry_count << ' ';  // 7 0
+		cache.read(ref).update([](Record& record) { record.id = 8; });
+		std::cout << cache.read_lazy(ref).get_field<&Record::id>() << std::endl;  // 8
+		cache.sweep();
+	}
+	block_manager.set_block_format(block_format::fixed);
+
+	return 0;
+}
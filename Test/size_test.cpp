@@ -0,0 +1,49 @@
+#include "BlockStore/utility/ref_split_control.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+static_assert(flat_layout<std::pair<block_ref, block_ref>>::is_static && flat_layout<std::pair<block_ref, block_ref>>::size == 2 * sizeof(ref_t));
+static_assert(!flat_layout<std::string>::is_static);
+
+
+int main() {
+	BlockManager block_manager("size_test.db");
+
+	// the computed size is the size of the data written, without the header
+	auto check = [&](const auto& object) {
+		using T = std::remove_cvref_t<decltype(object)>;
+		block<T> ref = block_manager.allocate();
+		ref.write(object);
+		std::cout << (ref.serialized_size(object) == ref.block_ref::read().size() - 1);
+	};
+	for (block_format format : { block_format::fixed, block_format::compact }) {
+		block_manager.set_block_format(format);
+		check(uint64(300));
+		check(std::pair<block_ref, block_ref>(block_manager.get_root(), block_manager.get_root()));
+		check(std::string("size"));
+		check(std::vector<uint64>{ 1, 1000, 1000000 });
+		check(std::vector<std::pair<uint64, std::string>>{ { 1, "one" }, { 70000, "seventy thousand" } });
+		check(std::vector<block_ref>(100, block_manager.get_root()));
+		std::cout << std::endl;
+	}
+
+	// trees of references split exactly at the block limit
+	block_manager.set_block_format(block_format::fixed);
+	size_t count = (block_size_limit - sizeof(size_t)) / sizeof(ref_t);
+	std::vector<block_ref> leaf(count, block_manager.get_root());
+	std::cout << TreeSplitControl<block_ref, void>::leaf_should_split(leaf) << ' ';
+	leaf.push_back(block_manager.get_root());
+	std::cout << TreeSplitControl<block_ref, void>::leaf_should_split(leaf) << std::endl;  // 0 1
+	block_manager.set_block_format(block_format::compact);
+	leaf.resize(block_size_limit - varint_size(block_size_limit), block_manager.get_root());  // one byte per reference
+	std::cout << TreeSplitControl<block_ref, void>::leaf_should_split(leaf) << ' ';
+	leaf.push_back(block_manager.get_root());
+	std::cout << TreeSplitControl<block_ref, void>::leaf_should_split(leaf) << std::endl;  // 0 1
+	block_manager.set_block_format(block_format::fixed);
+
+	return 0;
+}
@@ -0,0 +1,74 @@
+#include "BlockStore/data/cache.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("slab_test.db");
+	block<uint64>(block_manager.get_root()).write(0);
+	std::vector<block<uint64>> number_list;
+	std::vector<block<std::string>> text_list;
+	block_manager.transaction([&] {
+		for (uint64 i = 0; i < 200; ++i) {
+			number_list.emplace_back(block_manager.allocate()).write(i);
+			text_list.emplace_back(block_manager.allocate()).write(std::to_string(i));
+		}
+	});
+
+	BlockCacheDynamic cache(block_manager);
+
+	// objects of different types are kept side by side, and stay in place as the slabs grow
+	{
+		auto number = cache.read(number_list[0]);
+		auto text = cache.read(text_list[0]);
+		const uint64* number_address = &number.get();
+		const std::string* text_address = &text.get();
+		uint64 sum = 0; size_t length = 0;
+		for (size_t i = 1; i < 200; ++i) {
+			sum += cache.read(number_list[i]).get();
+			length += cache.read(text_list[i]).get().size();
+		}
+		std::cout << sum << ' ' << length << ' ' << cache.statistics().entry_count << ' ';  // 19900 489 400
+		std::cout << (&number.get() == number_address) << (&text.get() == text_address) << ' ' << text.get() << std::endl;  // 11 0
+	}
+
+	// a block cached as one type can't be read as another
+	try {
+		cache.read(block<std::string>(number_list[1])).get();
+	} catch (const std::invalid_argument& e) {
+		std::cout << e.what() << std::endl;
+	}
+
+	// the slots of swept entries are reused
+	cache.sweep();
+	std::cout << cache.statistics().entry_count << ' ';  // 0
+	cache.transaction([&] {
+		for (size_t i = 0; i < 200; ++i) { cache.read(text_list[i]).set(std::to_string(i * 2)); }
+	});
+	std::cout << cache.statistics().entry_count << ' ' << cache.read(text_list[199]).get() << ' ' << text_list[199].read() << std::endl;  // 200 398 398
+
+	// an insertion whose write-back flush fails leaves the cache usable
+	{
+		BlockCacheDynamic cache(block_manager, CacheOption{ .entry_limit = 4 });
+		cache.enable_write_back(WriteBackOption{ .time_limit = std::chrono::hours(1) });
+		for (size_t i = 0; i < 3; ++i) { cache.read(number_list[i]).set(i + 1000); }
+		auto view = cache.read(number_list[3]);
+		BlockManager reader("slab_test.db");
+		try {
+			reader.transaction([&] {
+				block<uint64>(reader.get_root()).read();  // holds the shared lock, so the flush can't commit
+				cache.read(number_list[4]).get();
+			});
+		} catch (const std::runtime_error&) {
+			std::cout << "flush failed ";
+		}
+		std::cout << cache.read(number_list[4]).get() << ' ';  // 4
+		cache.flush();
+		std::cout << number_list[2].read() << std::endl;  // 1002
+	}
+
+	return 0;
+}
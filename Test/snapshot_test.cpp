@@ -0,0 +1,53 @@
+#include "BlockStore/Item/List.h"
+#include "common.h"
+
+#include <thread>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("snapshot_test.db");
+	BlockCache<ListNode<int>> cache(block_manager);
+
+	block<std::tuple<>>(block_manager.get_root()).write({});
+
+	{
+		List<int, BlockCache> list(cache, block_manager.get_root());
+		cache.transaction([&] {
+			for (int i = 0; i < 10; ++i) {
+				list.emplace_back(i);
+			}
+		});
+		print(list);
+
+		std::unique_ptr<BlockManager> snapshot = block_manager.snapshot();
+
+		cache.transaction([&] {
+			for (int i = 0; i < 5; ++i) {
+				list.pop_front();
+				list.emplace_back(10 + i);
+			}
+		});
+		print(list);
+
+		std::thread scan([&] {
+			BlockCache<ListNode<int>> snapshot_cache(*snapshot);
+			List<int, BlockCache> snapshot_list(snapshot_cache, snapshot->get_root());
+			print(snapshot_list);
+		});
+		scan.join();
+
+		snapshot.reset();
+
+		std::unique_ptr<BlockManager> current = block_manager.snapshot();
+		BlockCache<ListNode<int>> current_cache(*current);
+		print(List<int, BlockCache>(current_cache, current->get_root()));
+	}
+
+	cache.sweep();
+	block_manager.gc(GCOption{});
+
+	return 0;
+}
@@ -0,0 +1,56 @@
+#include "BlockStore/data/cache.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+void print(const CacheStats& stats) {
+	std::cout << stats.lookup << ' ' << stats.hit << ' ' << stats.miss << ' ' << stats.write << ' ' << stats.update << ' ' << stats.flush << ' ' << stats.flush_skipped << ' ' << stats.swept << ' ' << stats.entry_count << std::endl;
+}
+
+
+int main() {
+	BlockManager block_manager("stats_test.db");
+	std::vector<block<std::string>> ref_list;
+	block_manager.transaction([&] {
+		for (size_t i = 0; i < 4; ++i) {
+			ref_list.emplace_back(block_manager.allocate()).write(std::string(100, 'a' + i));
+		}
+	});
+
+	// lookups, writes and updates through views, and the blocks written or skipped at commit
+	{
+		BlockCache<std::string> cache(block_manager);
+		for (auto& ref : ref_list) { cache.read(ref).get(); }
+		cache.read(ref_list[0]).get();
+		cache.read(ref_list[1]).set("b");  // an update of the object read by the view
+		cache.read(ref_list[2]).update([](std::string& text) { text = std::string(100, 'c'); });
+		print(cache.statistics());  // 7 3 4 0 2 1 1 0 4
+		std::cout << (cache.statistics().flush_bytes == 2 + serialized_size(std::string("b")) + serialized_size(std::string(100, 'c'))) << std::endl;  // 1
+		cache.sweep();
+		print(cache.statistics());  // 7 3 4 0 2 1 1 4 0
+		cache.reset_statistics();
+		print(cache.statistics());  // 0 0 0 0 0 0 0 0 0
+	}
+
+	// objects are measured by the size of their data, also in caches without a byte limit
+	{
+		BlockCacheDynamic long_text(block_manager), short_text(block_manager);
+		long_text.read(ref_list[0]).get();
+		short_text.read(ref_list[1]).get();
+		std::cout << (long_text.statistics().byte_count - short_text.statistics().byte_count == serialized_size(std::string(100, 'a')) - serialized_size(std::string("b"))) << std::endl;  // 1
+	}
+
+	// the counters of BlockCacheLocal are shared by all its views of a type
+	{
+		BlockManager other("stats_test.db");
+		BlockCacheLocal<std::string>::reset_statistics();
+		BlockCacheLocal<std::string>::read_lazy(ref_list[0]).get();
+		BlockCacheLocal<std::string>::read_lazy(other.get_root()).get([] { return std::string(); });
+		print(BlockCacheLocal<std::string>::statistics());  // 2 0 2 0 0 0 0 0 0
+	}
+
+	return 0;
+}
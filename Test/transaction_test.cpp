@@ -0,0 +1,63 @@
+#include "BlockStore/data/block.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("transaction_test.db");
+	block<int> root = block_manager.get_root();
+	root.write(0);
+
+	auto fail = [](auto f) {
+		try { f(); } catch (const std::runtime_error& e) { std::cout << "rolled back: " << e.what() << std::endl; }
+	};
+
+	// savepoints
+	block_manager.transaction([&] {
+		root.write(1);
+		fail([&] {
+			block_manager.savepoint([&] {
+				root.write(2);
+				throw std::runtime_error("inner savepoint");
+			});
+		});
+		std::cout << root.read() << std::endl;  // 1
+		block_manager.savepoint([&] {
+			root.write(3);
+			fail([&] {
+				block_manager.savepoint([&] {
+					root.write(4);
+					throw std::runtime_error("nested savepoint");
+				});
+			});
+		});
+		std::cout << root.read() << std::endl;  // 3
+	});
+	std::cout << root.read() << std::endl;  // 3
+
+	// an outermost savepoint is a transaction
+	fail([&] {
+		block_manager.savepoint([&] {
+			root.write(5);
+			throw std::runtime_error("outer savepoint");
+		});
+	});
+	std::cout << root.read() << std::endl;  // 3
+
+	// inner transactions only count the depth, so a failing one rolls back the outermost
+	fail([&] {
+		block_manager.transaction([&] {
+			root.write(6);
+			block_manager.transaction([&] {
+				root.write(7);
+			});
+			throw std::runtime_error("outer transaction");
+		});
+	});
+	std::cout << root.read() << std::endl;  // 3
+
+	return 0;
+}
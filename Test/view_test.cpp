@@ -0,0 +1,72 @@
+#include "BlockStore/Item/Tree.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("view_test.db");
+
+	// flat views over the data of a block
+	block<std::vector<std::pair<uint64, std::string>>> ref = block_manager.allocate();
+	ref.write({ { 1, "one" }, { 2, "two" }, { 3, "three" } });
+	{
+		block_view_bytes view(ref);
+		auto list = view.get();
+		std::cout << list.size() << ' ' << list[2].first().get() << ' ' << list[2].second().get() << std::endl;  // 3 3 three
+		for (auto item : list) {
+			std::cout << item.second().get() << ' ';
+		}
+		std::cout << std::endl;
+		try {
+			list[3];
+		} catch (const std::invalid_argument& e) {
+			std::cout << e.what() << std::endl;
+		}
+	}
+
+	// corrupt data is detected instead of read out of bounds
+	{
+		std::vector<std::byte> data(1 + 2 * sizeof(size_t));
+		size_t size = 2, length = 100;
+		std::memcpy(data.data() + 1, &size, sizeof(size_t));
+		std::memcpy(data.data() + 1 + sizeof(size_t), &length, sizeof(size_t));
+		static_cast<block_ref&>(ref).write(data, {});
+		try {
+			block_view_bytes(ref).get()[0].second();
+		} catch (const std::runtime_error& e) {
+			std::cout << e.what() << std::endl;
+		}
+	}
+
+	// lookups of uncached leaves search their data in place
+	{
+		using IntTree = Tree<int, void, std::less<int>, BlockCache>;
+		block<std::tuple<>>(block_manager.get_root()).write({});
+		{
+			BlockCache<TreeNode<int>> node_cache(block_manager);
+			BlockCache<TreeLeaf<int, void>> leaf_cache(block_manager);
+			IntTree tree(node_cache, leaf_cache, block_manager.get_root(), std::less<int>());
+			for (int i = 0; i < 40; i += 2) {
+				tree.insert(tree.lower_bound(i), i);
+			}
+		}
+		BlockCache<TreeNode<int>> node_cache(block_manager);
+		BlockCache<TreeLeaf<int, void>> leaf_cache(block_manager);
+		IntTree tree(node_cache, leaf_cache, block_manager.get_root(), std::less<int>());
+		for (int i = -1; i < 42; ++i) {
+			std::cout << tree.contains(i);
+		}
+		std::cout << std::endl;
+		std::cout << tree.contains(8) << tree.contains(9) << std::endl;  // 10
+		std::cout << leaf_cache.statistics().entry_count << std::endl;  // 0
+		block_manager.set_block_format(block_format::compact);
+		tree.insert(tree.lower_bound(41), 41);
+		leaf_cache.sweep();
+		std::cout << tree.contains(41) << tree.contains(42) << std::endl;  // 10
+	}
+
+	return 0;
+}
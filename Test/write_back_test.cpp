@@ -0,0 +1,69 @@
+#include "BlockStore/data/cache.h"
+
+#include <iostream>
+
+
+using namespace BlockStore;
+
+
+int main() {
+	BlockManager block_manager("write_back_test.db");
+	std::vector<block<uint64>> ref_list;
+	block_manager.transaction([&] {
+		for (uint64 i = 0; i < 4; ++i) {
+			ref_list.emplace_back(block_manager.allocate()).write(i);
+		}
+	});
+
+	// changes are kept until the limits are exceeded
+	{
+		BlockCache<uint64> cache(block_manager);
+		cache.enable_write_back(WriteBackOption{ .count_limit = 3, .time_limit = std::chrono::hours(1) });
+		cache.read(ref_list[0]).set(10);
+		cache.read(ref_list[1]).set(11);
+		std::cout << ref_list[0].read() << ' ';  // 0
+		cache.read(ref_list[2]).set(12);
+		std::cout << ref_list[0].read() << std::endl;  // 10
+
+		// and are not flushed inside a transaction of the manager, which could still roll them back
+		block_manager.transaction([&] {
+			cache.transaction([&] {
+				for (size_t i = 0; i < 4; ++i) { cache.read(ref_list[i]).set(i + 20); }
+			});
+			std::cout << ref_list[0].read() << ' ';  // 10
+			try {
+				cache.flush();
+			} catch (const std::invalid_argument& e) {
+				std::cout << e.what() << ' ';
+			}
+			try {
+				cache.sweep();
+			} catch (const std::invalid_argument& e) {
+				std::cout << e.what() << std::endl;
+			}
+		});
+		cache.transaction([] {});
+		std::cout << ref_list[0].read() << std::endl;  // 20
+
+		// the destructor flushes the remaining changes
+		cache.read(ref_list[3]).set(33);
+		std::cout << ref_list[3].read() << ' ';  // 23
+	}
+	std::cout << ref_list[3].read() << std::endl;  // 33
+
+	// or writes them in the transaction of the manager it is destroyed in, to be rolled back with it
+	try {
+		block_manager.transaction([&] {
+			{
+				BlockCache<uint64> cache(block_manager);
+				cache.enable_write_back(WriteBackOption{});
+				cache.read(ref_list[0]).set(40);
+			}
+			std::cout << ref_list[0].read() << ' ';  // 40
+			throw std::runtime_error("rollback");
+		});
+	} catch (const std::runtime_error&) {}
+	std::cout << ref_list[0].read() << ' ' << block_manager.get_discarded_write_count() << std::endl;  // 20 0
+
+	return 0;
+}